@@ -84,9 +84,47 @@ INLINE Bitboard DoubleMoveBB(Square sq, Bitboard targets) {
     return DoubleMove[sq] & targets;
 }
 
+// Returns the pieces along with every square next to them. The unused
+// file H catches anything shifted off the side, so two shifts suffice
+INLINE Bitboard DilateBB(Bitboard pieces) {
+
+    Bitboard row = pieces | pieces << 1 | pieces >> 1;
+
+    return (row | row << 8 | row >> 8) & full;
+}
+
+// Returns all squares reachable by a double move from any of the pieces
+INLINE Bitboard DoubleMovesBB(Bitboard pieces, Bitboard targets) {
+
+    Bitboard near = DilateBB(pieces);
+
+    return DilateBB(near) & ~near & targets;
+}
+
 INLINE Bitboard SingleMovesBB(Bitboard pieces, Bitboard targets) {
 
     Bitboard singles = pieces << 1 | pieces << 9 | pieces >> 7 | pieces << 8 | pieces >> 8 | pieces >> 1 | pieces >> 9 | pieces << 7;
 
     return singles & targets;
 }
+
+// Returns the targets adjacent to at least n (1 to 8) pieces, counting
+// the neighbours of all squares at once with saturating bit-sliced counters
+INLINE Bitboard AdjacentAtLeastBB(Bitboard pieces, Bitboard targets, int n) {
+
+    const Bitboard neighbours[8] = {
+        pieces << 1, pieces << 9, pieces >> 7, pieces << 8,
+        pieces >> 8, pieces >> 1, pieces >> 9, pieces << 7
+    };
+
+    // atLeast[k] holds the squares with more than k neighbours so far
+    Bitboard atLeast[8] = { 0 };
+
+    for (int i = 0; i < 8; ++i) {
+        for (int k = n - 1; k > 0; --k)
+            atLeast[k] |= atLeast[k-1] & neighbours[i];
+        atLeast[0] |= neighbours[i];
+    }
+
+    return atLeast[n-1] & targets;
+}
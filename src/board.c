@@ -30,6 +30,7 @@ uint8_t SqDistance[64][64];
 
 // Zobrist key tables
 uint64_t PieceKeys[PIECE_NB][64];
+uint64_t FlipKeys[64];
 uint64_t SideKey;
 
 const char PieceChars[]  = ".x.o";
@@ -72,6 +73,10 @@ CONSTR InitHashKeys() {
     // Black pieces
     for (Square sq = A1; sq <= H8; ++sq)
         PieceKeys[b][sq] = Rand64();
+
+    // Flipping a piece on a square
+    for (Square sq = A1; sq <= H8; ++sq)
+        FlipKeys[sq] = PieceKeys[b][sq] ^ PieceKeys[w][sq];
 }
 
 // Generates a hash key from scratch
@@ -80,41 +85,48 @@ static Key GenPosKey(const Position *pos) {
     Key key = 0;
 
     for (Square sq = A1; sq <= H8; ++sq)
-        if (pieceOn(sq) != EMPTY)
-            key ^= PieceKeys[pieceOn(sq)][sq];
+        if (PieceOn(pos, sq) != EMPTY)
+            key ^= PieceKeys[PieceOn(pos, sq)][sq];
 
     if (sideToMove == WHITE) key ^= SideKey;
 
     return key;
 }
 
-// Calculates the position key after a move. Fails for special moves.
+// Calculates the position key after a move, including a pass, without making it
 Key KeyAfter(const Position *pos, const Move move) {
 
-    Square from = fromSq(move);
+    Key key = pos->key ^ SideKey;
+
+    if (moveIsNull(move))
+        return key;
+
     Square to   = toSq(move);
-    Piece piece = pieceOn(from);
+    Piece piece = MakePiece(sideToMove);
 
-    return pos->key ^ PieceKeys[piece][from] ^ PieceKeys[piece][to] ^ SideKey;
-}
+    key ^= PieceKeys[piece][to];
 
-// Add a piece piece to a square
-static void AddPiece(Position *pos, const Square sq, const Piece piece) {
+    if (!moveIsSingle(move))
+        key ^= PieceKeys[piece][fromSq(move)];
 
-    const Color color = ColorOf(piece);
+    Bitboard flips = SingleMoveBB(to, colorBB(!sideToMove));
+    while (flips)
+        key ^= FlipKeys[PopLsb(&flips)];
 
-    // Update board
-    pieceOn(sq) = piece;
+    return key;
+}
 
-    // Update bitboards
-    pos->pieceBB   |= BB(sq);
-    colorBB(color) |= BB(sq);
+// Add a piece piece to a square
+static void AddPiece(Position *pos, const Square sq, const Piece piece) {
+    colorBB(ColorOf(piece)) |= BB(sq);
 }
 
-// Parse FEN and set up the position as described
-void ParseFen(const char *fen, Position *pos) {
+// Parse FEN and set up the game as described
+void ParseFen(const char *fen, Game *game) {
+
+    Position *pos = &game->pos;
 
-    memset(pos, 0, sizeof(Position));
+    memset(game, 0, sizeof(Game));
     char c, *copy = strdup(fen);
     char *token = strtok(copy, " ");
 
@@ -136,6 +148,7 @@ void ParseFen(const char *fen, Position *pos) {
 
     // Generate the position key
     pos->key = GenPosKey(pos);
+    game->keys[game->ply] = pos->key;
 
     free(copy);
 
@@ -156,7 +169,7 @@ char *BoardToFen(const Position *pos) {
 
         for (int file = FILE_A; file <= FILE_G; ++file) {
             Square sq = MakeSquare(rank, file);
-            Piece piece = pieceOn(sq);
+            Piece piece = PieceOn(pos, sq);
 
             if (piece) {
                 if (count)
@@ -189,7 +202,7 @@ void PrintBoard(const Position *pos) {
     for (int rank = RANK_7; rank >= RANK_1; --rank) {
         for (int file = FILE_A; file <= FILE_G; ++file) {
             Square sq = MakeSquare(rank, file);
-            printf("%3c", PieceChars[pieceOn(sq)]);
+            printf("%3c", PieceChars[PieceOn(pos, sq)]);
         }
         printf("\n");
     }
@@ -206,28 +219,12 @@ void PrintBoard(const Position *pos) {
 // Check board state makes sense
 bool PositionOk(const Position *pos) {
 
-    assert(0 <= pos->histPly && pos->histPly < MAXGAMEMOVES);
-    assert(    0 <= pos->ply && pos->ply < MAXDEPTH);
-
-    int counts[PIECE_NB] = { 0 };
-
-    for (Square sq = A1; sq <= H8; ++sq) {
-
-        Piece piece = pieceOn(sq);
-        counts[piece]++;
-    }
-
-    assert(PopCount(colorBB(WHITE)) == counts[MakePiece(WHITE)]);
-    assert(PopCount(colorBB(BLACK)) == counts[MakePiece(BLACK)]);
-
-    assert(PopCount(pos->pieceBB) ==  counts[MakePiece(WHITE)]
-                                    + counts[MakePiece(BLACK)]);
-
-    assert(pos->pieceBB == (colorBB(WHITE) | colorBB(BLACK)));
+    assert(!(colorBB(WHITE) & colorBB(BLACK)));
+    assert(!(pieceBB & unused));
 
     assert(sideToMove == WHITE || sideToMove == BLACK);
 
-    assert(GeneratePosKey(pos) == pos->key);
+    assert(GenPosKey(pos) == pos->key);
 
     return true;
 }
@@ -21,49 +21,47 @@
 #include "types.h"
 
 
-typedef struct {
-    Key key;
-    Bitboard captures;
-    Move move;
-    int rule50;
-} History;
-
+// Compact position state, small enough to be copied
+// to the next ply rather than made and unmade in place
 typedef struct Position {
 
-    uint8_t board[64];
-    Bitboard pieceBB;
     Bitboard colorBB[COLOR_NB];
+    Key key;
 
-    Color stm;
-    int rule50;
-    uint16_t histPly;
+    uint8_t stm;
+    uint8_t rule50;
     uint16_t gameMoves;
 
-    Key key;
+} Position;
 
-    uint64_t nodes;
+// The current game position along with a ring of the keys of
+// the positions leading up to it, used for repetition detection
+typedef struct Game {
 
-    History gameHistory[256];
+    Position pos;
+    Key keys[256];
+    uint8_t ply;
 
-} Position;
+} Game;
 
 
 extern uint8_t SqDistance[64][64];
 
 // Zobrist keys
 extern uint64_t PieceKeys[PIECE_NB][64];
-extern uint64_t CastleKeys[16];
+extern uint64_t FlipKeys[64];
 extern uint64_t SideKey;
 
 
 void InitDistance();
-void ParseFen(const char *fen, Position *pos);
+void ParseFen(const char *fen, Game *game);
 Key KeyAfter(const Position *pos, Move move);
 #ifndef NDEBUG
 void PrintBoard(const Position *pos);
 bool PositionOk(const Position *pos);
 #endif
 #ifdef DEV
+char *BoardToFen(const Position *pos);
 void PrintBoard(const Position *pos);
 #endif
 
@@ -99,9 +97,16 @@ INLINE bool ValidPiece(const Piece piece) {
     return piece == w || piece == b;
 }
 
-INLINE bool IsRepetition(const Position *pos) {
-    for (int i = 4; i <= pos->rule50 && i <= pos->histPly; i += 2)
-        if (pos->key == history(-i).key)
+INLINE Piece PieceOn(const Position *pos, const Square sq) {
+    return colorBB(WHITE) & BB(sq) ? w
+         : colorBB(BLACK) & BB(sq) ? b
+                                   : EMPTY;
+}
+
+// The ring index wraps around as ply is a uint8_t
+INLINE bool IsRepetition(const Position *pos, const Key keys[256], const uint8_t ply) {
+    for (int i = 4; i <= pos->rule50; i += 2)
+        if (pos->key == keys[(uint8_t)(ply - i)])
             return true;
     return false;
 }
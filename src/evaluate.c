@@ -16,22 +16,259 @@
   along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
 #include <stdlib.h>
+#include <string.h>
 
 #include "bitboard.h"
 #include "evaluate.h"
+#include "move.h"
+#include "weights.h"
+
+
+int EvalCacheKB = DEFAULT_EVAL_CACHE;
+
+const char *TermNames[TERM_NB] = {
+    "Material", "Singles", "Doubles", "Frontier", "Holes", "Safe"
+};
+
+// Value of each configuration of a 3x3 window from white's point of view,
+// expanded from the canonical ones in weights.h
+int16_t PatternWeights[PATTERN_NB];
+
+// Amount a square adds to the index of each window per unit of its digit
+int16_t PatternSteps[64][PATTERN_SLOTS];
+
+
+// Initializes the pattern window layout
+CONSTR InitPatternSteps() {
+
+    int pattern = 0;
+
+    for (int rank = RANK_2; rank <= RANK_6; ++rank)
+        for (int file = FILE_B; file <= FILE_F; ++file, ++pattern) {
+
+            int step = 1;
+
+            for (int r = rank - 1; r <= rank + 1; ++r)
+                for (int f = file - 1; f <= file + 1; ++f, step *= 3)
+                    PatternSteps[MakeSquare(r, f)][pattern] = step;
+        }
+}
+
+// Returns the index of the pattern after one of the 8 symmetries of the
+// square, optionally with the colors swapped
+static int TransformPattern(int index, const int symmetry, const bool swap) {
+
+    int digits[9], result = 0;
+
+    for (int i = 0; i < 9; ++i, index /= 3)
+        digits[i] = index % 3;
+
+    for (int r = 2; r >= 0; --r)
+        for (int f = 2; f >= 0; --f) {
+
+            int r2 = symmetry & 1 ? 2 - r : r;
+            int f2 = symmetry & 2 ? 2 - f : f;
+            int d  = symmetry & 4 ? digits[3 * f2 + r2] : digits[3 * r2 + f2];
+
+            result = 3 * result + (swap && d ? 3 - d : d);
+        }
+
+    return result;
+}
+
+// Maps a pattern to the lowest index among its symmetries and color swaps.
+// Returns the canonical index + 1, negated if the colors were swapped, or
+// 0 for patterns equal to their own color swap, which are worth nothing.
+int PatternCanonical(const int index) {
+
+    int plain = index, swapped = PATTERN_NB;
+
+    for (int symmetry = 0; symmetry < 8; ++symmetry)
+        plain   = MIN(plain,   TransformPattern(index, symmetry, false)),
+        swapped = MIN(swapped, TransformPattern(index, symmetry, true));
+
+    return plain < swapped ?   plain + 1
+         : swapped < plain ? -(swapped + 1)
+                           : 0;
+}
+
+// Expands the canonical pattern weights to all patterns
+CONSTR InitPatternWeights() {
+
+    static int16_t canonical[PATTERN_NB];
+
+    for (const PatternWeight *p = TunedPatterns; p->index; ++p)
+        canonical[p->index] = p->weight;
+
+    for (int index = 0; index < PATTERN_NB; ++index) {
+        int c = PatternCanonical(index);
+        PatternWeights[index] = c > 0 ?  canonical[ c - 1]
+                              : c < 0 ? -canonical[-c - 1]
+                                      : 0;
+    }
+}
+
+// Change the digit of a square in all pattern windows it is part of,
+// by +-1 for a flip and +-(color+1) for a stone added or removed
+INLINE void ChangeSquare(Patterns *patterns, const Square sq, const int change) {
+    for (int i = 0; i < PATTERN_SLOTS; ++i)
+        patterns->index[i] += change * PatternSteps[sq][i];
+}
+
+// Computes the pattern indices from scratch
+void RefreshPatterns(Patterns *patterns, const Position *pos) {
+
+    memset(patterns, 0, sizeof(Patterns));
+
+    for (Color color = BLACK; color <= WHITE; ++color) {
+        Bitboard stones = colorBB(color);
+        while (stones)
+            ChangeSquare(patterns, PopLsb(&stones), color + 1);
+    }
+}
+
+// Updates the pattern indices for a move made in pos, from the parent's
+void UpdatePatterns(Patterns *child, const Patterns *parent, const Position *pos, const Move move) {
+
+    // Works on a local copy, which the compiler keeps in registers
+    Patterns patterns = *parent;
+
+    if (!moveIsNull(move)) {
+
+        const Color color = sideToMove;
+        const Square to = toSq(move);
+        Bitboard flips = SingleMoveBB(to, colorBB(!color));
+
+        if (!moveIsSingle(move))
+            ChangeSquare(&patterns, fromSq(move), -(color + 1));
+
+        ChangeSquare(&patterns, to, color + 1);
+
+        while (flips)
+            ChangeSquare(&patterns, PopLsb(&flips), color == WHITE ? 1 : -1);
+    }
+
+    *child = patterns;
+}
+
+#if defined(__AVX2__)
+// DilateBB on four bitboards at once
+INLINE __m256i Dilate4(const __m256i v) {
+    __m256i row = _mm256_or_si256(v,   _mm256_or_si256(_mm256_slli_epi64(v,   1), _mm256_srli_epi64(v,   1)));
+    __m256i all = _mm256_or_si256(row, _mm256_or_si256(_mm256_slli_epi64(row, 8), _mm256_srli_epi64(row, 8)));
+    return _mm256_and_si256(all, _mm256_set1_epi64x(full));
+}
+#endif
+
+// Counts the stones or squares of each color for every term
+void CountTerms(const Position *pos, int counts[COLOR_NB][TERM_NB]) {
+
+    const Bitboard empty = full & ~pieceBB;
+
+    // Squares within one step of each color and of the empty squares,
+    // within two steps of each color, and stones next to an empty square
+    // the opponent can move to
+    Bitboard near[3], far[2], exposed[2];
+
+#if defined(__AVX2__)
+    // Black, white and empty in the low three lanes throughout, with
+    // colors swapped for the last step so they meet the opponent's reach
+    __m256i n = Dilate4(_mm256_set_epi64x(0, empty, colorBB(WHITE), colorBB(BLACK)));
+    __m256i f = Dilate4(n);
+    __m256i e = Dilate4(_mm256_and_si256(_mm256_permute4x64_epi64(f, _MM_SHUFFLE(3, 2, 0, 1)),
+                                         _mm256_set1_epi64x(empty)));
+
+    near[BLACK]    = _mm256_extract_epi64(n, 0);
+    near[WHITE]    = _mm256_extract_epi64(n, 1);
+    near[2]        = _mm256_extract_epi64(n, 2);
+    far[BLACK]     = _mm256_extract_epi64(f, 0);
+    far[WHITE]     = _mm256_extract_epi64(f, 1);
+    exposed[BLACK] = _mm256_extract_epi64(e, 0);
+    exposed[WHITE] = _mm256_extract_epi64(e, 1);
+#else
+    near[BLACK]    = DilateBB(colorBB(BLACK));
+    near[WHITE]    = DilateBB(colorBB(WHITE));
+    near[2]        = DilateBB(empty);
+    far[BLACK]     = DilateBB(near[BLACK]);
+    far[WHITE]     = DilateBB(near[WHITE]);
+    exposed[BLACK] = DilateBB(empty & far[WHITE]);
+    exposed[WHITE] = DilateBB(empty & far[BLACK]);
+#endif
+
+    for (Color color = BLACK; color <= WHITE; ++color) {
+
+        const Bitboard us = colorBB(color);
+
+        counts[color][MATERIAL]        = PopCount(us);
+        counts[color][SINGLE_MOBILITY] = PopCount(near[color] & empty);
+        counts[color][DOUBLE_MOBILITY] = PopCount(far[color] & ~near[color] & empty);
+        counts[color][FRONTIER]        = PopCount(us & near[2]);
+        counts[color][HOLES]           = PopCount(AdjacentAtLeastBB(us, empty & far[!color], 3));
+        counts[color][SAFE]            = PopCount(us & ~exposed[color]);
+    }
+}
+
+// Allocates the cache at the requested size, rounded down to a power of 2,
+// or frees it if the size is 0
+void InitEvalCache(EvalCache *cache) {
+
+    free(cache->entries);
+    memset(cache, 0, sizeof(EvalCache));
+
+    if (!EvalCacheKB) return;
+
+    uint64_t count = 1;
+    while (2 * count * sizeof(EvalEntry) <= (uint64_t)EvalCacheKB * 1024)
+        count *= 2;
+
+    cache->entries = calloc(count, sizeof(EvalEntry));
+    cache->mask = cache->entries ? count - 1 : 0;
+}
+
+void ClearEvalCache(EvalCache *cache) {
+    if (cache->entries)
+        memset(cache->entries, 0, (cache->mask + 1) * sizeof(EvalEntry));
+}
+
+// Calculate a static evaluation of a position, using the cache if given one
+int EvalPosition(const Position *pos, const Patterns *patterns, EvalCache *cache) {
+
+    EvalEntry *entry = NULL;
+
+    if (cache && cache->entries) {
+
+        entry = &cache->entries[pos->key & cache->mask];
+        cache->probes++;
+
+        if (entry->key == pos->key >> 32) {
+            cache->hits++;
+            return entry->eval;
+        }
+    }
+
+    int counts[COLOR_NB][TERM_NB];
+    CountTerms(pos, counts);
 
+    int eval = 0;
 
-// Bonus for being the side to move
-const int Tempo = 0;
+    // Stone and square counts
+    for (int term = 0; term < TERM_NB; ++term)
+        eval += TermWeights[term] * (counts[WHITE][term] - counts[BLACK][term]);
 
+    // Patterns
+    for (int i = 0; i < PATTERN_COUNT; ++i)
+        eval += PatternWeights[patterns->index[i]];
 
-// Calculate a static evaluation of a position
-int EvalPosition(const Position *pos) {
+    // Negate the evaluation if we are black
+    eval = (sideToMove == WHITE ? eval : -eval) + Tempo;
 
-    // Material
-    int eval = 200 * (PopCount(colorBB(WHITE)) - PopCount(colorBB(BLACK)));
+    if (entry)
+        *entry = (EvalEntry) { pos->key >> 32, eval };
 
-    // Return the evaluation, negated if we are black
-    return (sideToMove == WHITE ? eval : -eval) + Tempo;
+    return eval;
 }
@@ -22,8 +22,68 @@
 #include "types.h"
 
 
+// 3x3 windows centred on each of the 25 squares away from the edge,
+// padded to 32 so updating all of them at once vectorizes
+#define PATTERN_COUNT 25
+#define PATTERN_SLOTS 32
+
+// Pattern windows are indexed with a base 3 digit per square,
+// 0 for empty, 1 for black and 2 for white
+#define PATTERN_NB 19683 // 3^9
+
+// Size of each thread's eval cache in KB
+#define DEFAULT_EVAL_CACHE 128
+#define MAX_EVAL_CACHE     16384
+
+
+// Terms counted for each color, linear in their weights
+enum EvalTerm {
+    MATERIAL, SINGLE_MOBILITY, DOUBLE_MOBILITY, FRONTIER, HOLES, SAFE, TERM_NB
+};
+
+
+// Direct-mapped cache of evaluations, indexed by the low bits of the
+// position key and verified with the upper 32
+typedef struct EvalEntry {
+    uint32_t key;
+    int32_t eval;
+} EvalEntry;
+
+typedef struct EvalCache {
+    EvalEntry *entries;
+    uint64_t mask;
+    uint64_t probes;
+    uint64_t hits;
+} EvalCache;
+
+
+// Base 3 index of the stones in each pattern window, kept on the
+// search stack and updated incrementally like the NNUE accumulator
+typedef struct Patterns {
+    uint16_t index[PATTERN_SLOTS];
+} Patterns;
+
+typedef struct PatternWeight {
+    uint16_t index;
+    int16_t weight;
+} PatternWeight;
+
+
+extern int EvalCacheKB;
+
 extern const int Tempo;
+extern const int TermWeights[TERM_NB];
+extern const char *TermNames[TERM_NB];
+
+extern int16_t PatternWeights[PATTERN_NB];
+extern int16_t PatternSteps[64][PATTERN_SLOTS];
 
 
 // Returns a static evaluation of the position
-int EvalPosition(const Position *pos);
+int EvalPosition(const Position *pos, const Patterns *patterns, EvalCache *cache);
+void InitEvalCache(EvalCache *cache);
+void ClearEvalCache(EvalCache *cache);
+void CountTerms(const Position *pos, int counts[COLOR_NB][TERM_NB]);
+void RefreshPatterns(Patterns *patterns, const Position *pos);
+void UpdatePatterns(Patterns *child, const Patterns *parent, const Position *pos, Move move);
+int PatternCanonical(int index);
@@ -0,0 +1,59 @@
+/*
+  Weixx is a UAI compliant ataxx engine.
+  Copyright (C) 2020  Terje Kirstihagen
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdlib.h>
+
+#include "board.h"
+#include "move.h"
+#include "threads.h"
+#include "types.h"
+
+
+// Single moves have no from square, so they use the otherwise
+// impossible from == to entry to keep them apart from double moves
+#define HistoryEntry(move) (&thread->history[sideToMove][moveIsSingle(move) ? toSq(move) : fromSq(move)][toSq(move)])
+
+
+INLINE void HistoryBonus(int16_t *cur, int bonus) {
+    *cur += 32 * bonus - *cur * abs(bonus) / 512;
+}
+
+// Updates history and killers after a beta cutoff
+INLINE void UpdateHistory(Thread *thread, Stack *ss, Move bestMove, Depth depth, Move tried[], int triedCount) {
+
+    const Position *pos = &ss->pos;
+
+    if (moveIsNull(bestMove)) return;
+
+    // Update killers
+    if (ss->killers[0] != bestMove) {
+        ss->killers[1] = ss->killers[0];
+        ss->killers[0] = bestMove;
+    }
+
+    const int bonus = MIN(depth * depth, 16 * 16);
+
+    // Bonus to the move that caused the beta cutoff
+    HistoryBonus(HistoryEntry(bestMove), bonus);
+
+    // Penalize moves that failed to produce a cutoff
+    for (int i = 0; i < triedCount; ++i)
+        HistoryBonus(HistoryEntry(tried[i]), -bonus);
+}
@@ -19,69 +19,48 @@
 #include "bitboard.h"
 #include "board.h"
 #include "evaluate.h"
+#include "makemove.h"
 #include "move.h"
 
 
 #define HASH_PCE(piece, sq) (pos->key ^= PieceKeys[(piece)][(sq)])
+#define HASH_FLIP(sq)       (pos->key ^= FlipKeys[(sq)])
 #define HASH_SIDE           (pos->key ^= SideKey)
 
 
 // Remove a piece from a square sq
-static void ClearPiece(Position *pos, const Square sq, const bool hash) {
+INLINE void ClearPiece(Position *pos, const Square sq, const Color color) {
 
-    const Piece piece = pieceOn(sq);
-    const Color color = ColorOf(piece);
+    HASH_PCE(MakePiece(color), sq);
 
-    assert(ValidPiece(piece));
-
-    // Hash out the piece
-    if (hash)
-        HASH_PCE(piece, sq);
-
-    // Set square to empty
-    pieceOn(sq) = EMPTY;
-
-    // Update bitboards
-    pos->pieceBB   ^= BB(sq);
     colorBB(color) ^= BB(sq);
 }
 
-// Add a piece piece to a square
-static void AddPiece(Position *pos, const Square sq, const Piece piece, const bool hash) {
-
-    assert(pieceOn(sq) == EMPTY);
-
-    const Color color = ColorOf(piece);
+// Add a piece to a square
+INLINE void AddPiece(Position *pos, const Square sq, const Color color) {
 
-    // Hash in piece at square
-    if (hash)
-        HASH_PCE(piece, sq);
+    assert(!(pieceBB & BB(sq)));
 
-    // Update square
-    pieceOn(sq) = piece;
+    HASH_PCE(MakePiece(color), sq);
 
-    // Update bitboards
-    pos->pieceBB   ^= BB(sq);
     colorBB(color) ^= BB(sq);
 }
 
-// Move a piece from one square to another
-static void MovePiece(Position *pos, const Square from, const Square to, const bool hash) {
-    Piece piece = pieceOn(from);
-    ClearPiece(pos, from, hash);
-    AddPiece(pos, to, piece, hash);
+// Flip all captured pieces to the given color
+INLINE void FlipPieces(Position *pos, Bitboard captures, const Color color) {
+
+    // Update bitboards, the set of occupied squares is unchanged
+    colorBB( color) ^= captures;
+    colorBB(!color) ^= captures;
+
+    // Update hash
+    while (captures)
+        HASH_FLIP(PopLsb(&captures));
 }
 
 // Pass the turn without moving
 void MakeNullMove(Position *pos) {
 
-    // Save misc info for takeback
-    history(0).key    = pos->key;
-    history(0).move   = MOVE(0, 0, FLAG_NULL);
-    history(0).rule50 = pos->rule50;
-
-    // Incremental updates
-    pos->histPly++;
     pos->rule50 = 0;
     sideToMove ^= 1;
     HASH_SIDE;
@@ -89,91 +68,29 @@ void MakeNullMove(Position *pos) {
     assert(PositionOk(pos));
 }
 
-// Take back a null move
-void TakeNullMove(Position *pos) {
-
-    // Incremental updates
-    pos->histPly--;
-    sideToMove ^= 1;
-
-    // Get info from history
-    pos->key    = history(0).key;
-    pos->rule50 = history(0).rule50;
-
-    assert(PositionOk(pos));
-}
-
-// Make a move
+// Make a move, the search copies the position
+// beforehand so there is no need to take it back
 void MakeMove(Position *pos, const Move move) {
 
     if (moveIsNull(move))
         return MakeNullMove(pos);
 
-    // Save position
-    history(0).key    = pos->key;
-    history(0).move   = move;
-    history(0).rule50 = pos->rule50;
-
-    const Square from = fromSq(move);
+    const Color color = sideToMove;
     const Square to = toSq(move);
-    const bool single = moveIsSingle(move);
 
-    if (single)
-        AddPiece(pos, to, MakePiece(sideToMove), true), pos->rule50 = 0;
+    if (moveIsSingle(move))
+        pos->rule50 = 0;
     else
-        MovePiece(pos, from, to, true);
+        ClearPiece(pos, fromSq(move), color);
 
-    Bitboard captures = SingleMoveBB(to, colorBB(!sideToMove));
-    history(0).captures = captures;
+    AddPiece(pos, to, color);
 
-    while (captures) {
-        Square victim = PopLsb(&captures);
-        ClearPiece(pos, victim, true);
-        AddPiece(pos, victim, MakePiece(sideToMove), true);
-    }
+    FlipPieces(pos, SingleMoveBB(to, colorBB(!color)), color);
 
     // Incremental updates
-    pos->histPly++;
     pos->rule50++;
-    pos->nodes++;
     sideToMove ^= 1;
     HASH_SIDE;
 
     assert(PositionOk(pos));
 }
-
-// Take back the previous move
-void TakeMove(Position *pos) {
-
-    // Get the move from history
-    const Move move = history(-1).move;
-    const Square from = fromSq(move);
-    const Square to = toSq(move);
-    const bool single = moveIsSingle(move);
-
-    if (moveIsNull(move))
-        return TakeNullMove(pos);
-
-    // Incremental updates
-    pos->histPly--;
-    sideToMove ^= 1;
-
-    if (single)
-        ClearPiece(pos, to, false);
-    else
-        MovePiece(pos, to, from, false);
-
-    Bitboard captures = history(0).captures;
-
-    while (captures) {
-        Square victim = PopLsb(&captures);
-        ClearPiece(pos, victim, false);
-        AddPiece(pos, victim, MakePiece(!sideToMove), false);
-    }
-
-    // Get various info from history
-    pos->key    = history(0).key;
-    pos->rule50 = history(0).rule50;
-
-    assert(PositionOk(pos));
-}
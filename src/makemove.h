@@ -23,6 +23,4 @@
 
 
 void MakeMove(Position *pos, Move move);
-void TakeMove(Position *pos);
 void MakeNullMove(Position *pos);
-void TakeNullMove(Position *pos);
@@ -16,6 +16,7 @@
   along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <ctype.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -36,7 +37,7 @@ bool MoveIsLegal(const Position *pos, const Move move) {
     const Square to = toSq(move);
 
     // Can only move to empty squares
-    if (pos->pieceBB & BB(to)) return false;
+    if (pieceBB & BB(to)) return false;
 
     // A single move requires an allied piece adjacent to the destination
     if (moveIsSingle(move))
@@ -71,11 +72,14 @@ Move ParseMove(const char *str) {
 
     if (strstr(str, "0000") == str) return NULLMOVE;
 
+    // Single moves are given as only the destination square
+    if (!isalpha(str[2]))
+        return MOVE(0, StrToSq(str), FLAG_SINGLE);
+
     // Translate coordinates into square numbers
     Square from = StrToSq(str);
     Square to   = StrToSq(str+2);
 
-    int flag = Distance(from, to) == 1 ? FLAG_SINGLE : FLAG_NONE;
-
-    return MOVE(from, to, flag);
+    return Distance(from, to) == 1 ? MOVE(0, to, FLAG_SINGLE)
+                                   : MOVE(from, to, FLAG_NONE);
 }
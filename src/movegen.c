@@ -27,15 +27,32 @@ INLINE void AddMove(MoveList *list, const Square from, const Square to, const in
     list->moves[list->count++].move = MOVE(from, to, flag);
 }
 
-// Generate moves
-static void GenMoves(const Position *pos, MoveList *list, const Color color) {
+// Generate single moves, set-wise from all pieces at once
+void GenSingleMoves(const Position *pos, MoveList *list) {
 
-    const Bitboard empty = ~pos->pieceBB & ~unused;
-    Bitboard pieces = colorBB(color);
-    Bitboard singles = SingleMovesBB(pieces, empty);
+    const Bitboard empty = ~pieceBB & ~unused;
+    Bitboard singles = SingleMovesBB(colorBB(sideToMove), empty);
 
     while (singles)
         AddMove(list, 0, PopLsb(&singles), FLAG_SINGLE);
+}
+
+// Generate single moves flipping at least minFlips enemy stones
+void GenHighYieldSingles(const Position *pos, MoveList *list, const int minFlips) {
+
+    const Bitboard empty = ~pieceBB & ~unused;
+    Bitboard targets = AdjacentAtLeastBB(colorBB(!sideToMove), empty, minFlips);
+    Bitboard singles = SingleMovesBB(colorBB(sideToMove), targets);
+
+    while (singles)
+        AddMove(list, 0, PopLsb(&singles), FLAG_SINGLE);
+}
+
+// Generate double moves, one piece at a time
+void GenDoubleMoves(const Position *pos, MoveList *list) {
+
+    const Bitboard empty = ~pieceBB & ~unused;
+    Bitboard pieces = colorBB(sideToMove);
 
     while (pieces) {
 
@@ -47,11 +64,12 @@ static void GenMoves(const Position *pos, MoveList *list, const Color color) {
     }
 }
 
-// Generate noisy moves
+// Generate all moves, or a null move if there are none
 void GenAllMoves(const Position *pos, MoveList *list) {
 
     list->count = list->next = 0;
-    GenMoves(pos, list, sideToMove);
+    GenSingleMoves(pos, list);
+    GenDoubleMoves(pos, list);
 
     if (list->count == 0)
         list->moves[list->count++].move = NULLMOVE;
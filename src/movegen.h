@@ -34,4 +34,7 @@ typedef struct {
 } MoveList;
 
 
+void GenSingleMoves(const Position *pos, MoveList *list);
+void GenHighYieldSingles(const Position *pos, MoveList *list, int minFlips);
+void GenDoubleMoves(const Position *pos, MoveList *list);
 void GenAllMoves(const Position *pos, MoveList *list);
@@ -16,11 +16,67 @@
   along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include "bitboard.h"
 #include "board.h"
+#include "history.h"
 #include "move.h"
 #include "movepicker.h"
 
 
+// Ordering is primarily by stones gained, measured in quarter stones so
+// a double move can lose a little for each friendly stone bordering the
+// hole it leaves. History and killers only break ties within a gain.
+#define GainScale   65536
+#define KillerBonus 32768
+
+
+// Static ordering score of a move
+INLINE int GainScore(const Position *pos, const Move move) {
+
+    const Square to = toSq(move);
+    const int flips = PopCount(SingleMoveBB(to, colorBB(!sideToMove)));
+
+    if (moveIsSingle(move))
+        return 4 * (flips + 1);
+
+    const int exposed = PopCount(SingleMoveBB(fromSq(move), colorBB(sideToMove)));
+
+    return 4 * flips - exposed;
+}
+
+// Gives a score to each move left in the list
+static void ScoreMoves(MovePicker *mp) {
+
+    const Thread *thread = mp->thread;
+    const Position *pos = mp->pos;
+    MoveList *list = &mp->list;
+
+    for (int i = list->next; i < list->count; ++i) {
+
+        Move move = list->moves[i].move;
+
+        list->moves[i].score =  GainScore(pos, move) * GainScale
+                             +  *HistoryEntry(move)
+                             + (move == mp->kill1 || move == mp->kill2) * KillerBonus;
+    }
+}
+
+// Partial selection sort, moves the best scoring move to the front
+static void SortMoves(MoveList *list) {
+
+    int bestIdx = list->next;
+    int bestScore = list->moves[bestIdx].score;
+
+    for (int i = list->next + 1; i < list->count; ++i)
+        if (list->moves[i].score > bestScore)
+            bestScore = list->moves[i].score,
+            bestIdx = i;
+
+    MoveListEntry temp = list->moves[list->next];
+    list->moves[list->next] = list->moves[bestIdx];
+    list->moves[bestIdx] = temp;
+}
+
 // Return the next best move
 static Move PickNextMove(MovePicker *mp) {
 
@@ -29,23 +85,71 @@ static Move PickNextMove(MovePicker *mp) {
     if (list->next == list->count)
         return NOMOVE;
 
-    return list->moves[list->next++].move;
+    SortMoves(list);
+
+    Move move = list->moves[list->next++].move;
+
+    // Skip the TT move as it has already been tried
+    if (move == mp->ttMove)
+        return PickNextMove(mp);
+
+    return move;
 }
 
 // Returns the next move to try in a position
 Move NextMove(MovePicker *mp) {
 
-    Position *pos = &mp->thread->pos;
+    Position *pos = mp->pos;
+    Move move;
 
     // Switch on stage, falls through to the next stage
     // if a move isn't returned in the current stage.
     switch (mp->stage) {
-        case GEN:
-            GenAllMoves(pos, &mp->list);
+        case TTMOVE:
+            mp->stage++;
+            if (MoveIsLegal(pos, mp->ttMove))
+                return mp->ttMove;
+
+            // A TT move that wasn't tried, like a stored pass,
+            // must not be skipped when it's generated later
+            mp->ttMove = NOMOVE;
+
+            // fall through
+        case GEN_SINGLES:
+            GenSingleMoves(pos, &mp->list);
+            ScoreMoves(mp);
+            mp->stage++;
+
+            // fall through
+        case SINGLES:
+            if ((move = PickNextMove(mp)))
+                return move;
+
+            // Double moves are only generated if no single move caused a cutoff
             mp->stage++;
 
             // fall through
-        case PLAY:
+        case GEN_DOUBLES:
+            GenDoubleMoves(pos, &mp->list);
+
+            // Pass when there are no legal moves
+            if (mp->list.count == 0)
+                mp->list.moves[mp->list.count++].move = NULLMOVE;
+
+            ScoreMoves(mp);
+            mp->stage++;
+
+            // fall through
+        case DOUBLES:
+            return PickNextMove(mp);
+
+        case GEN_HIGH_YIELD:
+            GenHighYieldSingles(pos, &mp->list, QSMinFlips);
+            ScoreMoves(mp);
+            mp->stage++;
+
+            // fall through
+        case HIGH_YIELD:
             return PickNextMove(mp);
 
         default:
@@ -55,8 +159,21 @@ Move NextMove(MovePicker *mp) {
 }
 
 // Init normal movepicker
-void InitNormalMP(MovePicker *mp, Thread *thread) {
+void InitNormalMP(MovePicker *mp, Thread *thread, Stack *ss, Move ttMove) {
+    mp->list.count = mp->list.next = 0;
+    mp->thread = thread;
+    mp->pos = &ss->pos;
+    mp->ttMove = ttMove;
+    mp->kill1 = ss->killers[0];
+    mp->kill2 = ss->killers[1];
+    mp->stage = ttMove ? TTMOVE : GEN_SINGLES;
+}
+
+// Init quiescence movepicker
+void InitQuiescenceMP(MovePicker *mp, Thread *thread, Stack *ss) {
     mp->list.count = mp->list.next = 0;
     mp->thread = thread;
-    mp->stage = GEN;
+    mp->pos = &ss->pos;
+    mp->ttMove = mp->kill1 = mp->kill2 = NOMOVE;
+    mp->stage = GEN_HIGH_YIELD;
 }
@@ -21,16 +21,24 @@
 #include "types.h"
 
 
+// Quiescence only searches single moves flipping at least this many stones
+#define QSMinFlips 3
+
+
 typedef enum MPStage {
-    GEN, PLAY
+    TTMOVE, GEN_SINGLES, SINGLES, GEN_DOUBLES, DOUBLES,
+    GEN_HIGH_YIELD, HIGH_YIELD
 } MPStage;
 
 typedef struct MovePicker {
     Thread *thread;
+    Position *pos;
     MoveList list;
     MPStage stage;
+    Move ttMove, kill1, kill2;
 } MovePicker;
 
 
 Move NextMove(MovePicker *mp);
-void InitNormalMP(MovePicker *mp, Thread *thread);
+void InitNormalMP(MovePicker *mp, Thread *thread, Stack *ss, Move ttMove);
+void InitQuiescenceMP(MovePicker *mp, Thread *thread, Stack *ss);
@@ -0,0 +1,217 @@
+/*
+  Weixx is a UAI compliant ataxx engine.
+  Copyright (C) 2020  Terje Kirstihagen
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bitboard.h"
+#include "move.h"
+#include "nnue.h"
+
+
+bool UseNNUE = false;
+
+static Network net;
+
+// Difference between a square's own and enemy stone weights, all a flip changes
+static int16_t flipWeights[64][HIDDEN];
+
+#ifdef EVALFILE
+// Network embedded at build time
+__asm__(
+    ".section .rodata\n"
+    ".balign 32\n"
+    "EmbeddedNet:\n"
+    ".incbin \"" EVALFILE "\"\n"
+    "EmbeddedNetEnd:\n"
+    ".previous\n"
+);
+extern const char EmbeddedNet[], EmbeddedNetEnd[];
+#endif
+
+
+INLINE int Sq49(const Square sq) {
+    return RankOf(sq) * 7 + FileOf(sq);
+}
+
+// Input index of a stone of the given color, as seen from perspective
+INLINE int FeatureIndex(const Color perspective, const Color color, const Square sq) {
+    return (color == perspective ? 0 : 49) + Sq49(sq);
+}
+
+INLINE void AddWeights(int16_t *values, const int16_t *weights) {
+    for (int i = 0; i < HIDDEN; ++i)
+        values[i] += weights[i];
+}
+
+INLINE void SubWeights(int16_t *values, const int16_t *weights) {
+    for (int i = 0; i < HIDDEN; ++i)
+        values[i] -= weights[i];
+}
+
+static void InitFlipWeights() {
+    for (Square sq = A1; sq <= H8; ++sq)
+        if (!(BB(sq) & unused))
+            for (int i = 0; i < HIDDEN; ++i)
+                flipWeights[sq][i] = net.ftWeights[Sq49(sq)][i]
+                                   - net.ftWeights[49 + Sq49(sq)][i];
+}
+
+// Reads a network from memory, checking the header and size
+static bool ReadNetwork(const char *data, size_t size) {
+
+    uint32_t header[2];
+
+    if (size != sizeof(header) + sizeof(Network))
+        return false;
+
+    memcpy(header, data, sizeof(header));
+
+    if (header[0] != NET_MAGIC || header[1] != HIDDEN)
+        return false;
+
+    memcpy(&net, data + sizeof(header), sizeof(Network));
+    InitFlipWeights();
+
+    return true;
+}
+
+// A network equivalent to the material evaluation, used when no other is
+// available. One neuron counts own stones and another enemy stones.
+static void InitMaterialNetwork() {
+
+    memset(&net, 0, sizeof(Network));
+
+    for (int sq = 0; sq < 49; ++sq)
+        net.ftWeights[     sq][0] = 1,
+        net.ftWeights[49 + sq][1] = 1;
+
+    net.outWeights[0] =  200 * OUTPUT_DIV;
+    net.outWeights[1] = -200 * OUTPUT_DIV;
+
+    InitFlipWeights();
+}
+
+// Sets up the embedded network if there is one
+void InitNNUE() {
+#ifdef EVALFILE
+    if (ReadNetwork(EmbeddedNet, EmbeddedNetEnd - EmbeddedNet))
+        return;
+    puts("info string Embedded network is invalid, using material network");
+#endif
+    InitMaterialNetwork();
+}
+
+// Loads a network from file, keeping the current one on failure
+bool LoadNetwork(const char *path) {
+
+    FILE *file = fopen(path, "rb");
+    if (!file) return false;
+
+    static char buffer[2 * sizeof(uint32_t) + sizeof(Network) + 1];
+    size_t size = fread(buffer, 1, sizeof(buffer), file);
+    fclose(file);
+
+    return ReadNetwork(buffer, size);
+}
+
+// Computes the accumulator from scratch
+void RefreshAccumulator(Accumulator *acc, const Position *pos) {
+
+    for (Color perspective = BLACK; perspective <= WHITE; ++perspective) {
+
+        int16_t *values = acc->values[perspective];
+        memcpy(values, net.ftBiases, sizeof(net.ftBiases));
+
+        for (Color color = BLACK; color <= WHITE; ++color) {
+            Bitboard stones = colorBB(color);
+            while (stones)
+                AddWeights(values, net.ftWeights[FeatureIndex(perspective, color, PopLsb(&stones))]);
+        }
+    }
+}
+
+// Updates the accumulator for a move made in pos, from the parent's
+void UpdateAccumulator(Accumulator *child, const Accumulator *parent, const Position *pos, const Move move) {
+
+    memcpy(child, parent, sizeof(Accumulator));
+
+    if (moveIsNull(move))
+        return;
+
+    const Color color = sideToMove;
+    const Square to = toSq(move);
+    const Bitboard flips = SingleMoveBB(to, colorBB(!color));
+
+    for (Color perspective = BLACK; perspective <= WHITE; ++perspective) {
+
+        int16_t *values = child->values[perspective];
+
+        AddWeights(values, net.ftWeights[FeatureIndex(perspective, color, to)]);
+
+        if (!moveIsSingle(move))
+            SubWeights(values, net.ftWeights[FeatureIndex(perspective, color, fromSq(move))]);
+
+        // Flipping to our own color gains the flip weights, to the enemy loses them
+        Bitboard bb = flips;
+        while (bb)
+            color == perspective ? AddWeights(values, flipWeights[PopLsb(&bb)])
+                                 : SubWeights(values, flipWeights[PopLsb(&bb)]);
+    }
+}
+
+// Clipped ReLU of the accumulator dotted with the output weights
+static int32_t OutputLayer(const int16_t *values, const int16_t *weights) {
+
+#if defined(__AVX2__)
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i clip = _mm256_set1_epi16(CLIP);
+    __m256i sum = _mm256_setzero_si256();
+
+    for (int i = 0; i < HIDDEN; i += 16) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(values + i));
+        __m256i wt = _mm256_loadu_si256((const __m256i *)(weights + i));
+        v = _mm256_min_epi16(_mm256_max_epi16(v, zero), clip);
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(v, wt));
+    }
+
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(s);
+#else
+    int32_t sum = 0;
+    for (int i = 0; i < HIDDEN; ++i)
+        sum += CLAMP(values[i], 0, CLIP) * weights[i];
+    return sum;
+#endif
+}
+
+// Evaluates the position from the side to move's point of view
+int EvalNNUE(const Position *pos, const Accumulator *acc) {
+
+    int32_t output = OutputLayer(acc->values[ sideToMove], net.outWeights)
+                   + OutputLayer(acc->values[!sideToMove], net.outWeights + HIDDEN)
+                   + net.outBias;
+
+    return output / OUTPUT_DIV;
+}
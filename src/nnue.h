@@ -0,0 +1,56 @@
+/*
+  Weixx is a UAI compliant ataxx engine.
+  Copyright (C) 2020  Terje Kirstihagen
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "board.h"
+#include "types.h"
+
+
+// 49 squares for each of own and enemy stones, seen from each side
+#define INPUTS 98
+#define HIDDEN 64
+
+// Accumulators are clipped to [0, CLIP] before the output layer, and
+// the output is divided by OUTPUT_DIV to get the evaluation
+#define CLIP       127
+#define OUTPUT_DIV 64
+
+#define NET_MAGIC 0x4E4E5857 // "WXNN"
+
+
+typedef struct {
+    int16_t values[COLOR_NB][HIDDEN];
+} Accumulator;
+
+typedef struct {
+    int16_t ftWeights[INPUTS][HIDDEN];
+    int16_t ftBiases[HIDDEN];
+    int16_t outWeights[2 * HIDDEN];
+    int32_t outBias;
+} Network;
+
+
+extern bool UseNNUE;
+
+
+void InitNNUE();
+bool LoadNetwork(const char *path);
+void RefreshAccumulator(Accumulator *acc, const Position *pos);
+void UpdateAccumulator(Accumulator *child, const Accumulator *parent, const Position *pos, Move move);
+int EvalNNUE(const Position *pos, const Accumulator *acc);
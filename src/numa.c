@@ -0,0 +1,120 @@
+/*
+  Weixx is a UAI compliant ataxx engine.
+  Copyright (C) 2020  Terje Kirstihagen
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#if defined(__linux__)
+    #define _GNU_SOURCE
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "numa.h"
+
+
+#define MAX_NODES 64
+
+bool NumaPinning = false;
+
+static int nodeCount = 1;
+
+#if defined(__linux__)
+
+static cpu_set_t nodeCpus[MAX_NODES];
+
+// Reads a sysfs list like "0-15,32-47" and calls add for each number in it
+static bool ReadList(const char *path, void (*add)(int, void *), void *data) {
+
+    FILE *file = fopen(path, "r");
+    if (!file) return false;
+
+    char line[4096];
+    bool ok = fgets(line, sizeof(line), file);
+    fclose(file);
+    if (!ok) return false;
+
+    for (char *token = strtok(line, ",\n"); token; token = strtok(NULL, ",\n")) {
+        int first, last;
+        int read = sscanf(token, "%d-%d", &first, &last);
+        if (read < 1) continue;
+        if (read < 2) last = first;
+        for (int i = first; i <= last; ++i)
+            add(i, data);
+    }
+
+    return true;
+}
+
+static void AddNode(int node, void *nodes) {
+    if (node < MAX_NODES)
+        *(uint64_t *)nodes |= 1ull << node;
+}
+
+static void AddCpu(int cpu, void *cpus) {
+    if (cpu < CPU_SETSIZE)
+        CPU_SET(cpu, (cpu_set_t *)cpus);
+}
+
+// Detects the NUMA nodes that have cpus, falling back to a single node
+void InitNuma() {
+
+    uint64_t online = 0;
+    nodeCount = 0;
+
+    if (ReadList("/sys/devices/system/node/online", AddNode, &online))
+        for (int node = 0; node < MAX_NODES; ++node) {
+
+            if (!(online & (1ull << node))) continue;
+
+            char path[64];
+            sprintf(path, "/sys/devices/system/node/node%d/cpulist", node);
+
+            cpu_set_t *cpus = &nodeCpus[nodeCount];
+            CPU_ZERO(cpus);
+
+            // Skip memory-only nodes
+            if (ReadList(path, AddCpu, cpus) && CPU_COUNT(cpus))
+                nodeCount++;
+        }
+
+    nodeCount = nodeCount ?: 1;
+}
+
+// Pins the calling thread to a node, spreading consecutive indices
+// across nodes. Pages it touches first are then allocated locally.
+void BindToNode(int index) {
+
+    if (!NumaPinning || nodeCount < 2)
+        return;
+
+    cpu_set_t *cpus = &nodeCpus[index % nodeCount];
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), cpus);
+}
+
+#else
+
+void InitNuma() {}
+void BindToNode(int index) { (void)index; }
+
+#endif
+
+int NumaNodeCount() {
+    return nodeCount;
+}
@@ -24,10 +24,12 @@
 #include "bitboard.h"
 #include "board.h"
 #include "evaluate.h"
+#include "history.h"
 #include "makemove.h"
 #include "move.h"
 #include "movegen.h"
 #include "movepicker.h"
+#include "nnue.h"
 #include "time.h"
 #include "threads.h"
 #include "transposition.h"
@@ -39,39 +41,185 @@ SearchLimits Limits;
 volatile bool ABORT_SIGNAL = false;
 volatile bool SEARCH_STOPPED = true;
 
+// Late move reduction parameters, in hundredths of a ply
+int LMRBase    = 75;
+int LMRDivisor = 225;
+
+static int Reductions[32][32];
+
+// Margins are measured in stones, valued by the material weight
+#define Stone (TermWeights[MATERIAL])
+
+// Quiescence depth cap, and the margin on top of the stones
+// a move wins before delta pruning gives up on it
+#define QSMaxPly      8
+#define QSDeltaMargin Stone
+
+// Shallower nodes are searched too quickly for deferring to pay off
+#define ABDADADepth 3
+
+
+// Initializes the late move reduction array
+void InitReductions() {
+    for (int depth = 1; depth < 32; ++depth)
+        for (int moves = 1; moves < 32; ++moves)
+            Reductions[depth][moves] = LMRBase / 100.0 + log(depth) * log(moves) / (LMRDivisor / 100.0);
+}
+
+
+// Node limited searches stop once the threads together reach the limit,
+// but not before depth 1 gives a move. A single thread checks every node
+// so the result is reproducible.
+INLINE void CheckNodeLimit(const Thread *thread) {
+    if (   Limits.nodes
+        && thread->index == 0
+        && thread->completedDepth
+        && (thread->count == 1 || (thread->stats.nodes & 1023) == 0)
+        && TotalNodes() >= Limits.nodes)
+        ABORT_SIGNAL = true;
+}
+
+// Whether the move is one the search has been restricted to
+INLINE bool IsSearchMove(const Move move) {
+    for (int i = 0; i < Limits.searchMoveCount; ++i)
+        if (Limits.searchMoves[i] == move)
+            return true;
+    return false;
+}
+
+// Static evaluation of the position in the stack entry
+INLINE int Evaluate(Thread *thread, const Stack *ss) {
+    return UseNNUE ? EvalNNUE(&ss->pos, &ss->acc)
+                   : EvalPosition(&ss->pos, &ss->patterns, &thread->evalCache);
+}
+
+// Makes a move on a copy of the position in the next stack entry
+INLINE void PlayMove(Thread *thread, Stack *ss, const Move move) {
+
+    (ss+1)->pos = ss->pos;
+    MakeMove(&(ss+1)->pos, move);
+
+    if (UseNNUE)
+        UpdateAccumulator(&(ss+1)->acc, &ss->acc, &ss->pos, move);
+    else
+        UpdatePatterns(&(ss+1)->patterns, &ss->patterns, &ss->pos, move);
+
+    ss->move = move;
+    thread->stats.nodes++;
+}
+
+// Quiescence
+static int Quiescence(Thread *thread, Stack *ss, int alpha, int beta, Depth qply) {
+
+    Position *pos = &ss->pos;
+    MovePicker mp;
+    ss->pv.length = 0;
+
+    CheckNodeLimit(thread);
+
+    // Stop if out of time or nodes, or the search was stopped
+    if (ABORT_SIGNAL)
+        return 0;
+
+    thread->seldepth = MAX(thread->seldepth, ss->ply);
+
+    // Early exits
+    if (!colorBB(sideToMove))
+        return -MATE + ss->ply;
+
+    if (pieceBB == full)
+        return PopCount(colorBB( sideToMove)) >
+               PopCount(colorBB(!sideToMove)) ?  MATE_IN_MAX - ss->ply
+                                              : -MATE_IN_MAX + ss->ply;
+
+    int eval = Evaluate(thread, ss);
+
+    // Max depth reached
+    if (ss->ply >= MAX_PLY || qply >= QSMaxPly)
+        return eval;
+
+    // Stand pat
+    if (eval >= beta)
+        return eval;
+
+    alpha = MAX(alpha, eval);
+
+    InitQuiescenceMP(&mp, thread, ss);
+
+    int bestScore = eval;
+
+    // Move loop
+    Move move;
+    while ((move = NextMove(&mp))) {
+
+        const int flips = PopCount(SingleMoveBB(toSq(move), colorBB(!sideToMove)));
+
+        // Delta pruning, skip moves that can't raise alpha even
+        // if the opponent has no good reply
+        if (eval + (2 * flips + 1) * Stone + QSDeltaMargin <= alpha)
+            continue;
+
+        PlayMove(thread, ss, move);
+        thread->stats.qnodes++;
+
+        int score = -Quiescence(thread, ss+1, -beta, -alpha, qply + 1);
+
+        // The score is meaningless if the search was aborted
+        if (ABORT_SIGNAL)
+            return 0;
+
+        if (score > bestScore && (bestScore = score) > alpha) {
+
+            if (score >= beta)
+                return score;
+
+            alpha = score;
+        }
+    }
+
+    return bestScore;
+}
 
 // Alpha Beta
 static int AlphaBeta(Thread *thread, Stack *ss, int alpha, int beta, Depth depth) {
 
-    Position *pos = &thread->pos;
+    Position *pos = &ss->pos;
     MovePicker mp;
     ss->pv.length = 0;
 
     const bool pvNode = alpha != beta - 1;
     const bool root   = ss->ply == 0;
 
-    // Check time situation
-    if (OutOfTime(thread) || ABORT_SIGNAL)
-        longjmp(thread->jumpBuffer, true);
+    // Record the key for repetition detection further down the tree
+    const uint8_t histPly = thread->game.ply + ss->ply;
+    thread->game.keys[histPly] = pos->key;
+
+    CheckNodeLimit(thread);
+
+    // Stop if out of time or nodes, or the search was stopped
+    if (ABORT_SIGNAL)
+        return 0;
 
     // Early exits
     if (!root) {
 
+        thread->seldepth = MAX(thread->seldepth, ss->ply);
+
         if (!colorBB(sideToMove))
             return -MATE + ss->ply;
 
-        if (pos->pieceBB == full)
+        if (pieceBB == full)
             return PopCount(colorBB( sideToMove)) >
                    PopCount(colorBB(!sideToMove)) ?  MATE_IN_MAX - ss->ply
                                                   : -MATE_IN_MAX + ss->ply;
 
         // Position is drawn
-        if (IsRepetition(pos) || pos->rule50 >= 100)
+        if (IsRepetition(pos, thread->game.keys, histPly) || pos->rule50 >= 100)
             return 0;
 
         // Max depth reached
         if (ss->ply >= MAX_PLY)
-            return EvalPosition(pos);
+            return Evaluate(thread, ss);
 
         // Mate distance pruning
         alpha = MAX(alpha, -MATE + ss->ply);
@@ -82,19 +230,130 @@ static int AlphaBeta(Thread *thread, Stack *ss, int alpha, int beta, Depth depth
 
     // Quiescence at the end of search
     if (depth <= 0)
-        return EvalPosition(pos);
+        return Quiescence(thread, ss, alpha, beta, 0);
+
+    // Probe transposition table
+    bool ttHit;
+    TTEntry ttData;
+    Key posKey = pos->key;
+    TTEntry *tte = ProbeTT(posKey, &ttData, &ttHit);
+
+    thread->stats.ttProbes++;
+    thread->stats.ttHits += ttHit;
+
+    Move ttMove = ttHit ? ttData.move : NOMOVE;
+    int ttScore = ttHit ? ScoreFromTT(ttData.score, ss->ply) : NOSCORE;
+
+    // Trust TT if not a pvnode and the entry depth is sufficiently high
+    if (   !pvNode
+        && ttHit
+        && ttData.depth >= depth
+        && (Bound(&ttData) & (ttScore >= beta ? BOUND_LOWER : BOUND_UPPER)))
+        return ttScore;
+
+    int eval = ss->eval = Evaluate(thread, ss);
+
+    // Skip pruning at PV nodes, in early iterations, or if the last move was null
+    if (pvNode || !thread->doPruning || lastMoveNullMove)
+        goto move_loop;
+
+    // Reverse Futility Pruning
+    if (depth < 7 && eval - 7 * Stone / 8 * depth >= beta)
+        return eval;
+
+    // Null Move Pruning
+    if (   depth >= 3
+        && eval >= beta
+        && ss->ply >= thread->nmpMinPly) {
+
+        Depth reduction = 3 + depth / 4;
+
+        (ss+1)->pos = *pos;
+        MakeNullMove(&(ss+1)->pos);
+
+        if (UseNNUE)
+            (ss+1)->acc = ss->acc;
+        else
+            (ss+1)->patterns = ss->patterns;
+
+        ss->move = NULLMOVE;
+
+        int score = -AlphaBeta(thread, ss+1, -beta, -beta + 1, depth - reduction);
+
+        if (ABORT_SIGNAL)
+            return 0;
+
+        if (score >= beta) {
+
+            // Don't return unproven mate scores
+            score = score >= MATE_IN_MAX ? beta : score;
 
-    InitNormalMP(&mp, thread);
+            // Zugzwang is rare while the board is still open, and inside a
+            // verification search the outer one already guards against it
+            if (PopCount(~pieceBB & full) > 12 || thread->nmpMinPly)
+                return score;
 
+            // Passing is often best near the end of the game, so verify with a
+            // reduced search that doesn't allow null moves in the first plies
+            thread->nmpMinPly = ss->ply + 3 * (depth - reduction) / 4;
+            int verification = AlphaBeta(thread, ss, beta - 1, beta, depth - reduction);
+            thread->nmpMinPly = 0;
+
+            if (ABORT_SIGNAL)
+                return 0;
+
+            if (verification >= beta)
+                return score;
+        }
+    }
+
+move_loop:
+
+    InitNormalMP(&mp, thread, ss, ttMove);
+
+    Move tried[32];
+    int triedCount = 0;
+
+    // Moves deferred because another thread is searching them
+    Move deferred[256];
+    int deferredCount = 0, deferredNext = 0;
+    const bool abdada = UseABDADA && thread->count > 1 && depth >= ABDADADepth;
+
+    if (root)
+        thread->rootNodes = thread->bestMoveNodes = 0;
+
+    const int oldAlpha = alpha;
     int moveCount = 0;
     int bestScore = -INFINITE;
+    Move bestMove = NOMOVE;
     int score = -INFINITE;
 
-    // Move loop
+    // Move loop, ending with any deferred moves
     Move move;
-    while ((move = NextMove(&mp))) {
+    while (   (move = NextMove(&mp))
+           || (deferredNext < deferredCount && (move = deferred[deferredNext++]))) {
+
+        // Only search the given moves at the root
+        if (root && Limits.searchMoveCount && !IsSearchMove(move))
+            continue;
+
+        // Leave moves other threads are busy with until last, unless it's
+        // the first move or the deferred moves are being searched already
+        const Key moveKey = abdada ? MoveKey(pos->key, move) : 0;
+        if (abdada && moveCount && !deferredNext && IsBeingSearched(moveKey)) {
+            deferred[deferredCount++] = move;
+            continue;
+        }
+
+        const int flips = PopCount(SingleMoveBB(toSq(move), colorBB(!sideToMove)));
+
+        // Start loading the child's TT bucket, quiescence nodes don't probe it
+        if (depth > 1)
+            PrefetchTTBucket(KeyAfter(pos, move));
 
-        MakeMove(pos, move);
+        const uint64_t nodesBefore = thread->stats.nodes;
+
+        PlayMove(thread, ss, move);
 
         Depth extension = 0;
 
@@ -102,15 +361,52 @@ static int AlphaBeta(Thread *thread, Stack *ss, int alpha, int beta, Depth depth
 
         const Depth newDepth = depth - 1 + extension;
 
-        score = -AlphaBeta(thread, ss+1, -beta, -alpha, newDepth);
+        if (abdada)
+            StartSearching(moveKey);
+
+        bool doLMR = depth > 2 && moveCount > (2 + pvNode) && thread->doPruning;
 
-        // Undo the move
-        TakeMove(pos);
+        // Reduced depth zero-window search
+        if (doLMR) {
+            // Base reduction
+            int R = Reductions[MIN(31, depth)][MIN(31, moveCount)];
+            // Reduce less in pv nodes
+            R -= pvNode;
+            // Reduce less for moves flipping many stones
+            R -= flips / 3;
+
+            // Depth after reductions, avoiding going straight to quiescence
+            Depth RDepth = CLAMP(newDepth - R, 1, newDepth - 1);
+
+            score = -AlphaBeta(thread, ss+1, -alpha-1, -alpha, RDepth);
+        }
+
+        // Full depth zero-window search
+        if (doLMR ? score > alpha : !pvNode || moveCount > 1)
+            score = -AlphaBeta(thread, ss+1, -alpha-1, -alpha, newDepth);
+
+        // Full depth alpha-beta window search
+        if (pvNode && ((score > alpha && score < beta) || moveCount == 1))
+            score = -AlphaBeta(thread, ss+1, -beta, -alpha, newDepth);
+
+        if (abdada)
+            FinishSearching(moveKey);
+
+        // Unwind without touching the PV or TT if the search was aborted
+        if (ABORT_SIGNAL)
+            return 0;
+
+        // Track the effort spent on each root move for time management
+        const uint64_t moveNodes = thread->stats.nodes - nodesBefore;
+        if (root)
+            thread->rootNodes += moveNodes,
+            thread->bestMoveSearched |= move == thread->bestMove;
 
         // New best move
         if (score > bestScore) {
 
             bestScore = score;
+            bestMove  = move;
 
             // Update PV
             if ((score > alpha && pvNode) || (root && moveCount == 1)) {
@@ -124,79 +420,222 @@ static int AlphaBeta(Thread *thread, Stack *ss, int alpha, int beta, Depth depth
 
                 alpha = score;
 
+                // Fully searched and better than the moves before it, a
+                // candidate to play if the iteration is aborted
+                if (root)
+                    thread->partialMove   = move,
+                    thread->partialScore  = score,
+                    thread->bestMoveNodes = moveNodes;
+
                 // If score beats beta we have a cutoff
-                if (score >= beta)
+                if (score >= beta) {
+
+                    thread->stats.cutoffs++;
+                    thread->stats.firstMoveCutoffs += moveCount == 1;
+
+                    UpdateHistory(thread, ss, bestMove, depth, tried, triedCount);
                     break;
+                }
             }
         }
+
+        // Remember moves that failed to cut for history penalties
+        if (triedCount < 32)
+            tried[triedCount++] = move;
     }
 
+    // Store in TT
+    const int bound = bestScore >= beta ? BOUND_LOWER
+                    : alpha != oldAlpha ? BOUND_EXACT
+                                        : BOUND_UPPER;
+
+    StoreTTEntry(tte, posKey, bestMove, ScoreToTT(bestScore, ss->ply), depth, bound);
+
     return bestScore;
 }
 
 // Aspiration window
 static int AspirationWindow(Thread *thread, Stack *ss) {
 
+    const bool mainThread = thread->index == 0;
     int depth = thread->depth;
 
+    // Scores swing with the parity of the depth, so the window is
+    // centred on the last score from a search of the same parity
+    const int prevScore = thread->parityScore[depth & 1];
+
     int alpha = -INFINITE;
     int beta  =  INFINITE;
+    int delta = 2 * Stone;
 
     thread->doPruning = true;
 
-    int score = AlphaBeta(thread, ss, alpha, beta, depth);
+    // Shrink the window at higher depths
+    if (depth > 4 && abs(prevScore) < MATE_IN_MAX)
+        alpha = MAX(prevScore - delta, -INFINITE),
+        beta  = MIN(prevScore + delta,  INFINITE);
+
+    // Search with aspiration window until the result is inside the window
+    while (true) {
+
+        int score = AlphaBeta(thread, ss, alpha, beta, depth);
+
+        if (ABORT_SIGNAL)
+            return score;
+
+        if (mainThread)
+            PrintThinking(thread, ss, score, alpha, beta);
 
-    PrintThinking(thread, ss, score, alpha, beta);
+        // Failing low on a fully open window can't be helped by relaxing it
+        if (score <= alpha && alpha == -INFINITE)
+            return score;
 
-    return score;
+        // Failed low, relax lower bound and search again
+        if (score <= alpha) {
+            alpha = MAX(alpha - delta, -INFINITE);
+            beta  = (alpha + beta) / 2;
+
+        // Failed high, relax upper bound and search again
+        } else if (score >= beta)
+            beta = MIN(beta + delta, INFINITE);
+
+        // Score within the bounds is accepted as correct
+        else
+            return thread->parityScore[depth & 1] = score;
+
+        delta += delta / 2;
+    }
+}
+
+// Helper threads skip depths in different patterns, so they spread out
+// over the next few depths instead of all duplicating the main thread
+static const int SkipSize[20]  = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+static const int SkipPhase[20] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+
+INLINE bool SkipDepth(const Thread *thread) {
+    // With ABDADA all threads search the same depth and share the moves
+    if (thread->index == 0 || UseABDADA) return false;
+    const int i = (thread->index - 1) % 20;
+    return (thread->depth + SkipPhase[i]) / SkipSize[i] % 2;
 }
 
 // Iterative deepening
 static void *IterativeDeepening(void *voidThread) {
 
     Thread *thread = voidThread;
-    Position *pos = &thread->pos;
     Stack *ss = thread->ss+SS_OFFSET;
     bool mainThread = thread->index == 0;
 
     // Iterative deepening
     while (++thread->depth <= (mainThread ? Limits.depth : MAX_PLY)) {
 
-        // Jump here and return if we run out of allocated time mid-search
-        if (setjmp(thread->jumpBuffer)) break;
+        if (SkipDepth(thread)) continue;
+
+        thread->seldepth = 0;
+        thread->partialMove = NOMOVE;
+        thread->bestMoveSearched = false;
+
+        const int prevScore = thread->parityScore[thread->depth & 1];
 
         // Search position, using aspiration windows for higher depths
-        thread->score = AspirationWindow(thread, ss);
+        int score = AspirationWindow(thread, ss);
+
+        // Out of time mid-iteration, switch to the best root move found so
+        // far only if it has been compared with the last iteration's best
+        if (ABORT_SIGNAL) {
+            if (   thread->partialMove
+                && (   !thread->bestMove
+                    ||  thread->bestMoveSearched
+                    ||  thread->partialScore > thread->score)) {
+                thread->score      = thread->partialScore;
+                thread->bestMove   = thread->partialMove;
+                thread->ponderMove = ss->pv.line[0] == thread->partialMove
+                                  && ss->pv.length > 1 ? ss->pv.line[1] : NOMOVE;
+            }
+            break;
+        }
 
-        // Only the main thread concerns itself with the rest
-        if (!mainThread) continue;
+        thread->score = score;
+        thread->completedDepth = thread->depth;
 
-        bool uncertain = ss->pv.line[0] != thread->bestMove;
+        // Count iterations in a row with the same best move
+        thread->stability = ss->pv.line[0] == thread->bestMove ? thread->stability + 1 : 0;
 
         // Save bestMove and ponderMove before overwriting the pv next iteration
         thread->bestMove   = ss->pv.line[0];
         thread->ponderMove = ss->pv.length > 1 ? ss->pv.line[1] : NOMOVE;
 
-        // If an iteration finishes after optimal time usage, stop the search
-        if (   Limits.timelimit
-            && TimeSince(Limits.start) > Limits.optimalUsage * (1 + uncertain))
+        // Only the main thread concerns itself with the rest
+        if (!mainThread) continue;
+
+        // Stop once a short enough mate is found
+        if (   Limits.mate
+            && score >= MATE_IN_MAX
+            && (MATE - score + 1) / 2 <= Limits.mate)
+            break;
+
+        // Stop if the search seems settled for the time spent so far
+        if (StopEarly(thread, thread->depth > 4 ? prevScore - score : 0))
             break;
 
-        // Clear key history for seldepth calculation
-        for (int i = 1; i < MAX_PLY; ++i)
-            history(i).key = 0;
+        // Past the hard limit, which the timer leaves to us before depth 1 is done
+        if (Limits.timelimit && TimeSince(Limits.start) >= Limits.maxUsage)
+            break;
     }
 
     return NULL;
 }
 
+// Threads vote for their best move, weighted by depth and score
+static Thread *BestThread() {
+
+    Thread *best = threads;
+    int minScore = threads->score;
+
+    for (Thread *t = threads; t < threads + threads->count; ++t)
+        if (t->completedDepth)
+            minScore = MIN(minScore, t->score);
+
+    int votes[threads->count];
+    memset(votes, 0, sizeof(votes));
+
+    for (Thread *t = threads; t < threads + threads->count; ++t) {
+
+        if (!t->completedDepth) continue;
+
+        // Add this thread's weight to every thread sharing its move
+        for (int i = 0; i < threads->count; ++i)
+            if (threads[i].bestMove == t->bestMove)
+                votes[i] += (t->score - minScore + 20) * t->completedDepth;
+    }
+
+    for (Thread *t = threads + 1; t < threads + threads->count; ++t) {
+
+        if (!t->completedDepth) continue;
+
+        // Proven wins trump votes, and shorter is better
+        if (best->score >= MATE_IN_MAX || t->score >= MATE_IN_MAX) {
+            if (t->score > best->score)
+                best = t;
+            continue;
+        }
+
+        if (votes[t->index] > votes[best->index])
+            best = t;
+    }
+
+    return best;
+}
+
 // Root of search
-void *SearchPosition(void *pos) {
+void *SearchPosition(void *game) {
 
     SEARCH_STOPPED = false;
 
-    InitTimeManagement();
-    PrepareSearch(pos);
+    InitTimeManagement(&((Game *)game)->pos);
+    PrepareSearch(game);
+    NewSearchTT();
+    StartTimer();
 
     // Start helper threads and begin searching
     StartHelpers(IterativeDeepening);
@@ -207,10 +646,12 @@ void *SearchPosition(void *pos) {
 
     // Signal helper threads to stop and wait for them to finish
     ABORT_SIGNAL = true;
+    StopTimer();
     WaitForHelpers();
 
     // Print conclusion
-    PrintConclusion(threads);
+    PrintSearchStats();
+    PrintConclusion(BestThread());
 
     SEARCH_STOPPED = true;
     Wake();
@@ -24,9 +24,12 @@
 
 typedef struct {
     TimePoint start;
-    int time, inc, movestogo, movetime, depth;
+    int time, inc, movestogo, movetime, depth, mate;
     int optimalUsage, maxUsage;
+    uint64_t nodes;
     bool timelimit, infinite;
+    int searchMoveCount;
+    Move searchMoves[256];
 } SearchLimits;
 
 
@@ -34,5 +37,9 @@ extern SearchLimits Limits;
 extern volatile bool ABORT_SIGNAL;
 extern volatile bool SEARCH_STOPPED;
 
+extern int LMRBase;
+extern int LMRDivisor;
 
-void *SearchPosition(void *pos);
+
+void InitReductions();
+void *SearchPosition(void *game);
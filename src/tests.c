@@ -23,12 +23,174 @@
 #include "evaluate.h"
 #include "makemove.h"
 #include "move.h"
+#include "movegen.h"
 #include "movepicker.h"
+#include "nnue.h"
 #include "search.h"
 #include "threads.h"
 #include "time.h"
 #include "transposition.h"
+#include "uai.h"
+
+
+/* Benchmark */
+
+static const char *BenchmarkFENs[] = {
+    "x5o/7/7/7/7/7/o5x x 0 1",
+    "x3o2/7/7/3o3/4o2/o6/o6 x 0 4",
+    "xx3oo/7/7/7/6x/o4x1/oo4x x 0 4",
+    "1x4o/1o3o1/2o4/7/5x1/oo5/o6 o 0 5",
+    "x5o/7/7/2oo3/2oox2/7/o5x x 0 5",
+    "x3ooo/6o/7/7/3xx2/2xx3/xx5 o 0 5",
+    "xxxo2o/xxx2o1/7/7/7/6x/o5x o 0 5",
+    "x5o/x3oo1/4oo1/7/3oo2/2oo3/7 o 0 7",
+    "1xx4/1o5/1oo4/2ox3/3o3/7/o5x x 0 8",
+    "oo5/1o2oo1/6o/5o1/4o2/xx5/xx2x2 x 0 8",
+    "x6/4oo1/3ooo1/3oxx1/x4o1/7/7 x 0 11",
+    "x5x/3xxxx/3ox1x/4x2/3x3/oox4/1oo4 o 0 12",
+    "xx3xx/1x3x1/7/7/3oxx1/3oxx1/oo1xxxx o 0 12",
+    "1oo2oo/1oo1xx1/5xx/5xx/5oo/o1o1xx1/7 o 0 14",
+    "7/4o2/1xx4/oxxx3/oox1o2/1ox4/7 o 0 14",
+    "3oo2/xooooxo/2oooxx/1o2oo1/7/7/7 x 0 17",
+    "1o2ooo/2o1oo1/1o5/7/4o2/1xxooo1/2xooox x 0 19",
+    "4o2/2xxxxo/2oxxxo/2ox1x1/5oo/6o/o6 x 0 20",
+    "7/1x1oo2/x1xoo2/1oooo2/oooxxx1/1oox1xx/2x4 x 0 23",
+    "3oxxx/2xoxx1/2xx3/2xooo1/2xooox/2xoooo/1x1xooo o 0 27",
+    "x1o2x1/4xoo/3x1oo/2xxooo/2x1oxx/1xxxo1x/2x4 x 0 26",
+    "xxxxxo1/xxxxo2/1oooooo/3ooo1/2xxo2/2x1o1x/o5x x 0 36",
+    "1ox3o/ooxo3/oxxxo1x/1xxxxx1/oxxxxo1/xooxxoo/2xxx2 x 0 40",
+    "2ooox1/1xoooxo/1xoooxx/2ooooo/1xxooo1/3ooo1/3x3 x 0 40",
+};
+
+typedef struct BenchResult {
+    TimePoint elapsed;
+    uint64_t nodes;
+    int score;
+    Move best;
+} BenchResult;
+
+static const int FENCount = sizeof(BenchmarkFENs) / sizeof(char *);
+
+// Searches each position in turn, returning the totals
+static BenchResult RunBenchmark(BenchResult *results, uint64_t *cutoffs,
+                                uint64_t *firstMoveCutoffs, bool verbose) {
+
+    Game game;
+    BenchResult total = { 0 };
+
+    for (int i = 0; i < FENCount; ++i) {
+
+        if (verbose)
+            printf("[# %2d] %s\n", i+1, BenchmarkFENs[i]);
+
+        // Search
+        ParseFen(BenchmarkFENs[i], &game);
+        ABORT_SIGNAL = false;
+        Limits.start = Now();
+        SearchPosition(&game);
+
+        // Collect results
+        BenchResult *r = &results[i];
+        r->elapsed = TimeSince(Limits.start);
+        r->nodes   = TotalNodes();
+        r->score   = threads->score;
+        r->best    = threads->bestMove;
+
+        total.elapsed += r->elapsed;
+        total.nodes   += r->nodes;
+
+        SearchStats stats = TotalStats();
+        *cutoffs          += stats.cutoffs;
+        *firstMoveCutoffs += stats.firstMoveCutoffs;
+
+        TT.dirty = true;
+        ClearTT();
+    }
+
+    return total;
+}
+
+// Measures nps and time to depth using 1, 2, 4... up to the given number of threads
+static void Scaling(int argc, char **argv) {
+
+    // Default depth 10, up to 8 threads, 32MB hash, and lazy SMP
+    Limits.timelimit = false;
+    Limits.depth     = argc > 3 ? atoi(argv[3]) : 10;
+    int maxThreads   = argc > 4 ? atoi(argv[4]) : 8;
+    TT.requestedMB   = argc > 5 ? atoi(argv[5]) : DEFAULTHASH;
+    UseABDADA        = argc > 6 && !strcmp(argv[6], "abdada");
+
+    InitThreads(1);
+    InitTT();
 
+    BenchResult results[FENCount];
+    uint64_t cutoffs = 0, firstMoveCutoffs = 0;
+    double baseNps = 0;
+    TimePoint baseTime = 0;
+
+    for (int count = 1; ; count = MIN(2 * count, maxThreads)) {
+
+        InitThreads(count);
+
+        BenchResult total = RunBenchmark(results, &cutoffs, &firstMoveCutoffs, false);
+        double nps = 1000.0 * total.nodes / (total.elapsed + 1);
+        baseNps  = baseNps  ?: nps;
+        baseTime = baseTime ?: total.elapsed + 1;
+
+        // The main thread stops at the given depth, so the time
+        // taken shows how much the helpers help it get there
+        printf("Threads %4d: %10d nps  speedup %5.2f  efficiency %5.1f%%"
+               "  time to depth %7" PRId64 " ms  speedup %5.2f\n",
+               count, (int)nps, nps / baseNps, 100.0 * nps / baseNps / count,
+               total.elapsed, (double)baseTime / (total.elapsed + 1));
+        fflush(stdout);
+
+        if (count == maxThreads)
+            break;
+    }
+}
+
+// Searches a fixed set of positions to a fixed depth
+void Benchmark(int argc, char **argv) {
+
+    if (argc > 2 && !strcmp(argv[2], "scaling")) {
+        Scaling(argc, argv);
+        return;
+    }
+
+    // Default depth 10, 1 thread, 32MB hash, and material eval
+    Limits.timelimit = false;
+    Limits.depth     = argc > 2 ? atoi(argv[2]) : 10;
+    int threadCount  = argc > 3 ? atoi(argv[3]) : 1;
+    TT.requestedMB   = argc > 4 ? atoi(argv[4]) : DEFAULTHASH;
+    UseNNUE          = argc > 5 && !strcmp(argv[5], "nnue");
+
+    InitThreads(threadCount);
+    InitTT();
+
+    BenchResult results[FENCount];
+    uint64_t cutoffs = 0, firstMoveCutoffs = 0;
+
+    BenchResult total = RunBenchmark(results, &cutoffs, &firstMoveCutoffs, true);
+    TimePoint totalElapsed = total.elapsed;
+    uint64_t totalNodes    = total.nodes;
+
+    puts("======================================================");
+
+    for (int i = 0; i < FENCount; ++i) {
+        BenchResult *r = &results[i];
+        printf("[# %2d] %6d cp  %-5s %10" PRIu64 " nodes %10d nps\n",
+               i+1, r->score, MoveToStr(r->best), r->nodes,
+               (int)(1000.0 * r->nodes / (r->elapsed + 1)));
+    }
+
+    puts("======================================================");
+
+    printf("OVERALL: %7" PRId64 " ms %13" PRIu64 " nodes %10d nps\n",
+           totalElapsed, totalNodes, (int)(1000.0 * totalNodes / (totalElapsed + 1)));
+    printf("First move cutoffs: %.1f%%\n", 100.0 * firstMoveCutoffs / (cutoffs + !cutoffs));
+    fflush(stdout);
+}
 
 #ifdef DEV
 
@@ -45,12 +207,12 @@
 
 /* Perft */
 
-static uint64_t RecursivePerft(Thread *thread, const Depth depth) {
+static uint64_t RecursivePerft(Thread *thread, Stack *ss, const Depth depth) {
 
-    Position *pos = &thread->pos;
+    Position *pos = &ss->pos;
 
     if (depth == 0) return 1;
-    if (!colorBB(sideToMove) || pos->pieceBB == full) return 0;
+    if (!colorBB(sideToMove) || pieceBB == full) return 0;
 
     uint64_t leafnodes = 0;
 
@@ -61,43 +223,43 @@ static uint64_t RecursivePerft(Thread *thread, const Depth depth) {
 
 //     for (int i = list.next; i < list.count; ++i) {
 //         Move move = list.moves[i].move;
-//         MakeMove(pos, move);
-//         leafnodes += RecursivePerft(thread, depth - 1);
-//         TakeMove(pos);
+//         (ss+1)->pos = *pos;
+//         MakeMove(&(ss+1)->pos, move);
+//         leafnodes += RecursivePerft(thread, ss+1, depth - 1);
 //     }
 
     MovePicker mp;
-    InitNormalMP(&mp, thread);
+    InitNormalMP(&mp, thread, ss, NOMOVE);
 
     Move move;
     while ((move = NextMove(&mp))) {
-        MakeMove(pos, move);
-        leafnodes += RecursivePerft(thread, depth - 1);
-        TakeMove(pos);
+        (ss+1)->pos = *pos;
+        MakeMove(&(ss+1)->pos, move);
+        leafnodes += RecursivePerft(thread, ss+1, depth - 1);
     }
 
     return leafnodes;
 }
 
-// static uint64_t SplitPerft(Thread *thread, const Depth depth) {
+// static uint64_t SplitPerft(Thread *thread, Stack *ss, const Depth depth) {
 
-//     Position *pos = &thread->pos;
+//     Position *pos = &ss->pos;
 
 //     if (depth == 0) return 1;
-//     if (!colorBB(sideToMove) || pos->pieceBB == full) return 0;
+//     if (!colorBB(sideToMove) || pieceBB == full) return 0;
 
 //     uint64_t leafnodes = 0;
 
 //     MovePicker mp;
-//     InitNormalMP(&mp, thread, NOMOVE);
+//     InitNormalMP(&mp, thread, ss, NOMOVE);
 
 //     Move move;
 //     while ((move = NextMove(&mp))) {
-//         MakeMove(pos, move);
-//         uint64_t perft = RecursivePerft(thread, depth - 1);
+//         (ss+1)->pos = *pos;
+//         MakeMove(&(ss+1)->pos, move);
+//         uint64_t perft = RecursivePerft(thread, ss+1, depth - 1);
 //         printf("%s: %" PRIu64 "\n", MoveToStr(move), perft);
 //         leafnodes += perft;
-//         TakeMove(pos);
 //     }
 
 //     return leafnodes;
@@ -113,13 +275,14 @@ void Perft(char *str) {
     char *fen = strtok(NULL, "\0") ?: default_fen;
 
     Depth depth = d ? atoi(d) : 5;
-    ParseFen(fen, &threads->pos);
+    ParseFen(fen, &threads->game);
+    threads->ss->pos = threads->game.pos;
 
     printf("\nPerft starting:\nDepth : %d\nFEN   : %s\n", depth, fen);
     fflush(stdout);
 
     const TimePoint start = Now();
-    uint64_t leafNodes = RecursivePerft(threads, depth);
+    uint64_t leafNodes = RecursivePerft(threads, threads->ss, depth);
     const TimePoint elapsed = TimeSince(start) + 1;
 
     printf("\nPerft complete:"
@@ -130,8 +293,182 @@ void Perft(char *str) {
     fflush(stdout);
 }
 
+/* Move picker check */
+
+// Checks that the staged move picker returns exactly the moves GenAllMoves does
+static bool RecursiveMPCheck(Thread *thread, Stack *ss, const Depth depth) {
+
+    Position *pos = &ss->pos;
+
+    if (depth == 0) return true;
+    if (!colorBB(sideToMove) || pieceBB == full) return true;
+
+    MoveList list;
+    GenAllMoves(pos, &list);
+
+    // Use one of the moves as TT move to also cover that stage
+    MovePicker mp;
+    InitNormalMP(&mp, thread, ss, list.moves[depth % list.count].move);
+
+    bool found[256] = { 0 };
+    int count = 0;
+
+    Move move;
+    while ((move = NextMove(&mp))) {
+
+        int i = 0;
+        while (i < list.count && list.moves[i].move != move) ++i;
+
+        if (i == list.count || found[i]) {
+            printf("Bad move %s in %s\n", MoveToStr(move), BoardToFen(pos));
+            return false;
+        }
+
+        found[i] = true;
+        count++;
+    }
+
+    if (count != list.count) {
+        printf("Missing %d moves in %s\n", list.count - count, BoardToFen(pos));
+        return false;
+    }
+
+    for (int i = 0; i < list.count; ++i) {
+        (ss+1)->pos = *pos;
+        MakeMove(&(ss+1)->pos, list.moves[i].move);
+
+        if (KeyAfter(pos, list.moves[i].move) != (ss+1)->pos.key) {
+            printf("Bad key after %s in %s\n", MoveToStr(list.moves[i].move), BoardToFen(pos));
+            return false;
+        }
+
+        Accumulator refreshed;
+        UpdateAccumulator(&(ss+1)->acc, &ss->acc, pos, list.moves[i].move);
+        RefreshAccumulator(&refreshed, &(ss+1)->pos);
+
+        if (memcmp(&refreshed, &(ss+1)->acc, sizeof(Accumulator))) {
+            printf("Bad accumulator after %s in %s\n", MoveToStr(list.moves[i].move), BoardToFen(pos));
+            return false;
+        }
+
+        Patterns refreshedPatterns;
+        UpdatePatterns(&(ss+1)->patterns, &ss->patterns, pos, list.moves[i].move);
+        RefreshPatterns(&refreshedPatterns, &(ss+1)->pos);
+
+        if (memcmp(&refreshedPatterns, &(ss+1)->patterns, sizeof(Patterns))) {
+            printf("Bad patterns after %s in %s\n", MoveToStr(list.moves[i].move), BoardToFen(pos));
+            return false;
+        }
+
+        if (!RecursiveMPCheck(thread, ss+1, depth - 1))
+            return false;
+    }
+
+    return true;
+}
+
+// Verifies the move picker against full move generation to some depth
+void MPCheck(char *str) {
+
+    strtok(str, " ");
+    char *d = strtok(NULL, " ");
+    char *fen = strtok(NULL, "\0") ?: START_FEN;
+
+    Depth depth = d ? atoi(d) : 4;
+    ParseFen(fen, &threads->game);
+    threads->ss->pos = threads->game.pos;
+    RefreshAccumulator(&threads->ss->acc, &threads->ss->pos);
+    RefreshPatterns(&threads->ss->patterns, &threads->ss->pos);
+
+    printf("Move picker check to depth %d: %s\n", depth,
+           RecursiveMPCheck(threads, threads->ss, depth) ? "OK" : "FAILED");
+    fflush(stdout);
+}
+
+/* Prefetch benchmark */
+
+// Plays random games, probing the TT after every move, with and without
+// prefetching the bucket of the child before making the move
+void PrefetchBench(char *str) {
+
+    strtok(str, " ");
+    char *mb = strtok(NULL, " ");
+
+    TT.requestedMB = mb ? atoi(mb) : DEFAULTHASH;
+    InitTT();
+
+    const int steps = 4000000;
+    TimePoint elapsed[2];
+
+    for (int prefetch = 0; prefetch <= 1; ++prefetch) {
+
+        uint64_t seed = 1070372, hits = 0;
+        Game game;
+        MoveList list;
+        ParseFen(START_FEN, &game);
+        Position position = game.pos, *pos = &position;
+        GenAllMoves(pos, &list);
+
+        const TimePoint start = Now();
+
+        for (int i = 0; i < steps; ++i) {
+
+            seed ^= seed >> 12, seed ^= seed << 25, seed ^= seed >> 27;
+            Move move = list.moves[seed % list.count].move;
+
+            if (prefetch)
+                PrefetchTTBucket(KeyAfter(pos, move));
+
+            MakeMove(pos, move);
+
+            // Some work before the probe, as in the search
+            GenAllMoves(pos, &list);
+
+            bool ttHit;
+            TTEntry ttData;
+            ProbeTT(pos->key, &ttData, &ttHit);
+            hits += ttHit;
+
+            // Start over when the game is decided
+            if (!colorBB(sideToMove) || pieceBB == full || pos->rule50 >= 100)
+                *pos = game.pos,
+                GenAllMoves(pos, &list);
+        }
+
+        elapsed[prefetch] = TimeSince(start) + 1;
+
+        printf("%-12s %6" PRId64 "ms %6" PRId64 "ns/move  (%" PRIu64 " hits)\n",
+               prefetch ? "Prefetch" : "No prefetch", elapsed[prefetch],
+               elapsed[prefetch] * 1000000 / steps, hits);
+    }
+
+    printf("Hidden: %" PRId64 "ns/move\n", (elapsed[0] - elapsed[1]) * 1000000 / steps);
+    fflush(stdout);
+}
+
 void PrintEval(Position *pos) {
-    printf("%d\n", sideToMove == WHITE ? EvalPosition(pos) : -EvalPosition(pos));
+
+    int counts[COLOR_NB][TERM_NB];
+    CountTerms(pos, counts);
+
+    Patterns indices;
+    RefreshPatterns(&indices, pos);
+
+    printf("\n      Term | Black | White | Score\n");
+    printf("-----------+-------+-------+------\n");
+
+    for (int term = 0; term < TERM_NB; ++term)
+        printf("%10s | %5d | %5d | %5d\n", TermNames[term], counts[BLACK][term], counts[WHITE][term],
+               TermWeights[term] * (counts[WHITE][term] - counts[BLACK][term]));
+
+    int patterns = 0;
+    for (int i = 0; i < PATTERN_COUNT; ++i)
+        patterns += PatternWeights[indices.index[i]];
+
+    printf("%10s |       |       | %5d\n", "Patterns", patterns);
+    printf("-----------+-------+-------+------\n");
+    const int eval = EvalPosition(pos, &indices, NULL);
+    printf("Total (white's view): %d\n\n", sideToMove == WHITE ? eval : -eval);
     fflush(stdout);
 }
 #endif
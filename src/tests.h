@@ -21,7 +21,10 @@
 #include "types.h"
 
 
+void Benchmark(int argc, char **argv);
 #ifdef DEV
 void Perft(char *line);
+void MPCheck(char *line);
+void PrefetchBench(char *line);
 void PrintEval(Position *pos);
 #endif
@@ -17,81 +17,215 @@
 */
 
 #include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "numa.h"
 #include "threads.h"
 
 
 Thread *threads;
 static pthread_t *pthreads;
+static int poolSize;
+
+// Used for waiting until all workers have set themselves up
+static pthread_mutex_t poolMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t poolCondition = PTHREAD_COND_INITIALIZER;
+static int readyCount;
 
 // Used for letting the main thread sleep without using cpu
 static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t sleepCondition = PTHREAD_COND_INITIALIZER;
 
 
-// Allocates memory for thread structs
+// Workers sleep here between jobs
+static void *IdleLoop(void *voidThread) {
+
+    Thread *thread = voidThread;
+    const int index = thread - threads;
+
+    // Pin the worker before it touches its thread struct, so the
+    // pages are allocated on the worker's own node
+    BindToNode(index);
+
+    memset(thread, 0, sizeof(Thread));
+    thread->index = index;
+    thread->count = poolSize;
+    InitEvalCache(&thread->evalCache);
+    pthread_mutex_init(&thread->mutex, NULL);
+    pthread_cond_init(&thread->sleepCondition, NULL);
+
+    pthread_mutex_lock(&poolMutex);
+    readyCount++;
+    pthread_cond_signal(&poolCondition);
+    pthread_mutex_unlock(&poolMutex);
+
+    pthread_mutex_lock(&thread->mutex);
+
+    while (true) {
+
+        while (!thread->job && !thread->exit)
+            pthread_cond_wait(&thread->sleepCondition, &thread->mutex);
+
+        if (thread->exit)
+            break;
+
+        pthread_mutex_unlock(&thread->mutex);
+        thread->job(thread->jobArg);
+        pthread_mutex_lock(&thread->mutex);
+
+        // Let anyone waiting know the job is done
+        thread->job = NULL;
+        pthread_cond_broadcast(&thread->sleepCondition);
+    }
+
+    pthread_mutex_unlock(&thread->mutex);
+
+    return NULL;
+}
+
+// Waits for the worker to finish its current job
+static void WaitForJob(Thread *thread) {
+    pthread_mutex_lock(&thread->mutex);
+    while (thread->job)
+        pthread_cond_wait(&thread->sleepCondition, &thread->mutex);
+    pthread_mutex_unlock(&thread->mutex);
+}
+
+// Hands the worker a job, waiting for any previous job to finish first
+static void RunJob(Thread *thread, void *(*func)(void *), void *arg) {
+    pthread_mutex_lock(&thread->mutex);
+    while (thread->job)
+        pthread_cond_wait(&thread->sleepCondition, &thread->mutex);
+    thread->job = func;
+    thread->jobArg = arg;
+    pthread_cond_broadcast(&thread->sleepCondition);
+    pthread_mutex_unlock(&thread->mutex);
+}
+
+// Stops and joins all workers
+static void DestroyThreads() {
+
+    for (int i = 0; i < threads->count; ++i) {
+        Thread *thread = &threads[i];
+        pthread_mutex_lock(&thread->mutex);
+        thread->exit = true;
+        pthread_cond_broadcast(&thread->sleepCondition);
+        pthread_mutex_unlock(&thread->mutex);
+    }
+
+    for (int i = 0; i < threads->count; ++i) {
+        pthread_join(pthreads[i], NULL);
+        pthread_mutex_destroy(&threads[i].mutex);
+        pthread_cond_destroy(&threads[i].sleepCondition);
+        free(threads[i].evalCache.entries);
+    }
+
+    free(threads);
+    free(pthreads);
+}
+
+// Allocates memory for thread structs and starts a worker for each,
+// the workers zero and set up their own struct
 void InitThreads(int count) {
 
-    if (threads)  free(threads);
-    if (pthreads) free(pthreads);
+    if (threads) DestroyThreads();
 
-    threads  = calloc(count, sizeof(Thread));
+    // Thread is page aligned, so its size is a multiple of the page size
+    threads  = aligned_alloc(4096, count * sizeof(Thread));
     pthreads = calloc(count, sizeof(pthread_t));
 
-    // Each thread knows its own index and total thread count
+    // Allocation failed
+    if (!threads || !pthreads) {
+        printf("Failed to allocate %d threads.\n", count);
+        exit(EXIT_FAILURE);
+    }
+
+    poolSize = count;
+    readyCount = 0;
+
     for (int i = 0; i < count; ++i)
-        threads[i].index = i,
-        threads[i].count = count;
+        pthread_create(&pthreads[i], NULL, IdleLoop, &threads[i]);
+
+    pthread_mutex_lock(&poolMutex);
+    while (readyCount < count)
+        pthread_cond_wait(&poolCondition, &poolMutex);
+    pthread_mutex_unlock(&poolMutex);
 }
 
+// Reads a counter another thread may be incrementing
+#define ReadStat(stat) __atomic_load_n(&(stat), __ATOMIC_RELAXED)
+
 // Tallies the nodes searched by all threads
 uint64_t TotalNodes() {
     uint64_t total = 0;
     for (int i = 0; i < threads->count; ++i)
-        total += threads[i].pos.nodes;
+        total += ReadStat(threads[i].stats.nodes);
+    return total;
+}
+
+// Tallies all the search statistics of all threads
+SearchStats TotalStats() {
+    SearchStats total = { 0 };
+    for (int i = 0; i < threads->count; ++i) {
+        SearchStats *s = &threads[i].stats;
+        total.nodes            += ReadStat(s->nodes);
+        total.qnodes           += ReadStat(s->qnodes);
+        total.ttProbes         += ReadStat(s->ttProbes);
+        total.ttHits           += ReadStat(s->ttHits);
+        total.cutoffs          += ReadStat(s->cutoffs);
+        total.firstMoveCutoffs += ReadStat(s->firstMoveCutoffs);
+    }
     return total;
 }
 
 // Setup threads for a new search
-void PrepareSearch(Position *pos) {
+void PrepareSearch(Game *game) {
     for (Thread *t = threads; t < threads + threads->count; ++t) {
-        memset(t, 0, offsetof(Thread, pos));
-        memcpy(&t->pos, pos, sizeof(Position));
+        memset(t, 0, offsetof(Thread, game));
+        memcpy(&t->game, game, sizeof(Game));
+        t->evalCache.probes = t->evalCache.hits = 0;
+        (t->ss+SS_OFFSET)->pos = game->pos;
+        RefreshAccumulator(&(t->ss+SS_OFFSET)->acc, &game->pos);
+        RefreshPatterns(&(t->ss+SS_OFFSET)->patterns, &game->pos);
         for (Depth d = 0; d <= MAX_PLY; ++d)
             (t->ss+SS_OFFSET+d)->ply = d;
     }
 }
 
 // Start the main thread running the provided function
-void StartMainThread(void *(*func)(void *), Position *pos) {
-    pthread_create(&pthreads[0], NULL, func, pos);
-    pthread_detach(pthreads[0]);
+void StartMainThread(void *(*func)(void *), Game *game) {
+    RunJob(&threads[0], func, game);
 }
 
 // Start helper threads running the provided function
 void StartHelpers(void *(*func)(void *)) {
     for (int i = 1; i < threads->count; ++i)
-        pthread_create(&pthreads[i], NULL, func, &threads[i]);
+        RunJob(&threads[i], func, &threads[i]);
 }
 
 // Wait for helper threads to finish
 void WaitForHelpers() {
     for (int i = 1; i < threads->count; ++i)
-        pthread_join(pthreads[i], NULL);
+        WaitForJob(&threads[i]);
 }
 
 // Reset all data that isn't reset each turn
 void ResetThreads() {
+    for (int i = 0; i < threads->count; ++i) {
+        memset(threads[i].history, 0, sizeof(threads[i].history));
+        ClearEvalCache(&threads[i].evalCache);
+    }
 }
 
 // Run the given function once in each thread
 void RunWithAllThreads(void *(*func)(void *)) {
     for (int i = 0; i < threads->count; ++i)
-        pthread_create(&pthreads[i], NULL, func, &threads[i]);
+        RunJob(&threads[i], func, &threads[i]);
     for (int i = 0; i < threads->count; ++i)
-        pthread_join(pthreads[i], NULL);
+        WaitForJob(&threads[i]);
 }
 
 // Thread sleeps until it is woken up
@@ -18,9 +18,11 @@
 
 #pragma once
 
-#include <setjmp.h>
+#include <pthread.h>
 
 #include "board.h"
+#include "evaluate.h"
+#include "nnue.h"
 #include "types.h"
 
 
@@ -28,31 +30,70 @@
 
 
 typedef struct {
+    Position pos;
+    Accumulator acc;
+    Patterns patterns;
     int eval;
     Depth ply;
+    Move move;
+    Move killers[2];
     PV pv;
 } Stack;
 
+typedef int16_t ButterflyHistory[COLOR_NB][64][64];
+
+// Counters written only by their own thread and read by the main
+// thread, kept on a cache line of their own
+typedef struct {
+    uint64_t nodes;
+    uint64_t qnodes;
+    uint64_t ttProbes;
+    uint64_t ttHits;
+    uint64_t cutoffs;
+    uint64_t firstMoveCutoffs;
+} __attribute__((aligned(64))) SearchStats;
+
 typedef struct Thread {
 
+    SearchStats stats;
+
     Stack ss[128];
-    jmp_buf jumpBuffer;
     Depth depth;
+    Depth seldepth;
+    Depth completedDepth;
+    Depth nmpMinPly;
     bool doPruning;
-    bool uncertain;
+    int stability;
+    uint64_t rootNodes;
+    uint64_t bestMoveNodes;
     int multiPV;
 
     int score;
+    int parityScore[2];
     Move bestMove;
     Move ponderMove;
+    Move partialMove;
+    int partialScore;
+    bool bestMoveSearched;
 
     // Anything below here is not zeroed out between searches
-    Position pos;
+    Game game;
+    ButterflyHistory history;
+    EvalCache evalCache;
 
     int index;
     int count;
 
-} Thread;
+    // Worker thread, sleeps until given a job. Written by other
+    // threads, so kept off the cache lines used in search
+    __attribute__((aligned(64))) pthread_mutex_t mutex;
+    pthread_cond_t sleepCondition;
+    void *(*job)(void *);
+    void *jobArg;
+    bool exit;
+
+// Page aligned so each thread's memory can live on its own NUMA node
+} __attribute__((aligned(4096))) Thread;
 
 
 extern Thread *threads;
@@ -60,9 +101,10 @@ extern Thread *threads;
 
 void InitThreads(int threadCount);
 uint64_t TotalNodes();
+SearchStats TotalStats();
 uint64_t TotalTBHits();
-void PrepareSearch(Position *pos);
-void StartMainThread(void *(*func)(void *), Position *pos);
+void PrepareSearch(Game *game);
+void StartMainThread(void *(*func)(void *), Game *game);
 void StartHelpers(void *(*func)(void *));
 void WaitForHelpers();
 void ResetThreads();
@@ -16,13 +16,26 @@
   along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <errno.h>
+#include <pthread.h>
+
+#include "bitboard.h"
 #include "search.h"
 #include "time.h"
 #include "types.h"
 
 
+// The timer thread sleeps until the deadline, then aborts the search
+static pthread_t timerThread;
+static pthread_mutex_t timerMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t timerCondition;
+static bool timerStarted;
+static bool timerArmed;
+static TimePoint deadline;
+
+
 // Decide how much time to spend this turn
-void InitTimeManagement() {
+void InitTimeManagement(const Position *pos) {
 
     const int overhead = 5;
 
@@ -32,18 +45,117 @@ void InitTimeManagement() {
 
     // In movetime mode just use all the time given each turn
     if (Limits.movetime) {
-        Limits.maxUsage = Limits.optimalUsage = Limits.movetime - overhead;
+        Limits.maxUsage = Limits.optimalUsage = MAX(1, Limits.movetime - overhead);
         return;
     }
 
-    Limits.maxUsage = Limits.time / 30;
-    Limits.optimalUsage = Limits.time / 30;
+    // Every single move fills a square and the game nearly always ends with
+    // a full board, so the empty squares give a good estimate of the moves
+    // left. Double moves stretch it out, about 4/5 of a move per square.
+    const int empty = PopCount(~pieceBB & full);
+    int movesLeft = empty * 4 / 5 + 6;
+
+    if (Limits.movestogo)
+        movesLeft = MIN(movesLeft, Limits.movestogo);
+
+    // Time for the rest of the game, keeping back the overhead of each move
+    const int timeLeft = MAX(0, Limits.time
+                              + Limits.inc * (movesLeft - 1)
+                              - overhead   *  movesLeft);
+
+    Limits.optimalUsage = timeLeft / movesLeft;
+    Limits.maxUsage = MIN(4 * Limits.optimalUsage, Limits.time * 3 / 4 - overhead);
+    Limits.maxUsage = MAX(1, Limits.maxUsage);
+    Limits.optimalUsage = MIN(Limits.optimalUsage, Limits.maxUsage);
+}
+
+// Decides after an iteration whether to stop the search. The optimal time
+// is stretched when the best move keeps changing, when the score is
+// dropping, or when the best move took few of the nodes at the root.
+bool StopEarly(const Thread *thread, const int scoreDrop) {
+
+    if (!Limits.timelimit)
+        return false;
+
+    if (Limits.movetime)
+        return TimeSince(Limits.start) >= Limits.optimalUsage;
+
+    const double fraction = thread->rootNodes ? (double)thread->bestMoveNodes / thread->rootNodes
+                                              : 0.5;
+
+    const double stability = 1.4 - 0.08 * MIN(thread->stability, 8);
+    const double drop      = 1.0 + CLAMP(scoreDrop, 0, 400) / 800.0;
+    const double effort    = 1.5 - fraction;
+
+    return TimeSince(Limits.start) > Limits.optimalUsage * stability * drop * effort;
 }
 
-// Check time situation
-bool OutOfTime(Thread *thread) {
-    return (thread->pos.nodes & 4095) == 4095
-        && thread->index == 0
-        && Limits.timelimit
-        && TimeSince(Limits.start) >= Limits.maxUsage;
+static void *TimerLoop(void *arg) {
+
+    (void)arg;
+
+    pthread_mutex_lock(&timerMutex);
+
+    while (true) {
+
+        while (!timerArmed)
+            pthread_cond_wait(&timerCondition, &timerMutex);
+
+        // Sleep until the deadline unless the search finishes first,
+        // rereading it each time in case the timer was rearmed
+        while (timerArmed) {
+
+            struct timespec wakeup = { deadline / 1000, deadline % 1000 * 1000000 };
+
+            if (   pthread_cond_timedwait(&timerCondition, &timerMutex, &wakeup) == ETIMEDOUT
+                && Now() >= deadline)
+                break;
+        }
+
+        // The search needs depth 1 to have a move at all, the main
+        // thread stops by itself once it is done if this is too early
+        if (timerArmed) {
+            if (threads->completedDepth)
+                ABORT_SIGNAL = true;
+            timerArmed = false;
+        }
+    }
+
+    return NULL;
+}
+
+// Arms the timer to abort the search once the hard limit is reached
+void StartTimer() {
+
+    if (!Limits.timelimit)
+        return;
+
+    pthread_mutex_lock(&timerMutex);
+
+    if (!timerStarted) {
+        pthread_condattr_t attr;
+        pthread_condattr_init(&attr);
+        pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+        pthread_cond_init(&timerCondition, &attr);
+        pthread_create(&timerThread, NULL, TimerLoop, NULL);
+        timerStarted = true;
+    }
+
+    deadline = Limits.start + Limits.maxUsage;
+    timerArmed = true;
+    pthread_cond_signal(&timerCondition);
+
+    pthread_mutex_unlock(&timerMutex);
+}
+
+// Disarms the timer when the search ends before the deadline
+void StopTimer() {
+
+    if (!timerStarted)
+        return;
+
+    pthread_mutex_lock(&timerMutex);
+    timerArmed = false;
+    pthread_cond_signal(&timerCondition);
+    pthread_mutex_unlock(&timerMutex);
 }
@@ -33,5 +33,7 @@ INLINE int TimeSince(const TimePoint tp) {
     return Now() - tp;
 }
 
-void InitTimeManagement();
-bool OutOfTime(Thread *thread);
+void InitTimeManagement(const Position *pos);
+bool StopEarly(const Thread *thread, int scoreDrop);
+void StartTimer();
+void StopTimer();
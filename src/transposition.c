@@ -31,15 +31,70 @@
 
 TranspositionTable TT = { .requestedMB = DEFAULTHASH };
 
+bool UseABDADA = false;
+volatile Key Searching[SEARCHING_SIZE];
 
-// Probe the transposition table
-TTEntry* ProbeTT(const Key key, bool *ttHit) {
 
-    TTEntry* tte = GetEntry(key);
+// Entries are read and written whole, as a single 8 byte word
+INLINE TTEntry Load(const TTEntry *tte) {
+    TTEntry entry;
+    memcpy(&entry, tte, sizeof(TTEntry));
+    return entry;
+}
+
+// Folds the non-key fields of an entry into 16 bits
+INLINE uint16_t Checksum(const TTEntry *entry) {
+    uint64_t word;
+    memcpy(&word, entry, sizeof(TTEntry));
+    word >>= 16;
+    return word ^ word >> 16 ^ word >> 32;
+}
+
+INLINE uint16_t EntryKey(const TTEntry *entry) {
+    return entry->key ^ Checksum(entry);
+}
+
+// Shallow entries from old searches are the first to be replaced
+INLINE int EntryValue(const TTEntry *entry) {
+    return entry->depth - 8 * Age(entry);
+}
+
+// Probe the transposition table, returns the matching entry or else
+// the least valuable one in the bucket, copying its data into ttData
+TTEntry* ProbeTT(const Key key, TTEntry *ttData, bool *ttHit) {
+
+    TTEntry *bucket = GetBucket(key)->entry;
+    const uint16_t key16 = key >> 48;
 
-    *ttHit = tte->key == key;
+    TTEntry *replace = bucket;
+    int replaceValue = INT32_MAX;
 
-    return tte;
+    for (TTEntry *tte = bucket; tte < bucket + BUCKET_SIZE; ++tte) {
+
+        TTEntry entry = Load(tte);
+
+        if (EntryKey(&entry) == key16 && Bound(&entry) != BOUND_NONE) {
+
+            // Refresh the generation so entries still in use aren't
+            // treated as old, rewriting the checksum to match
+            if (Age(&entry)) {
+                entry.genBound = TT.generation | Bound(&entry);
+                entry.key = key16 ^ Checksum(&entry);
+                memcpy(tte, &entry, sizeof(TTEntry));
+            }
+
+            *ttData = entry;
+            *ttHit = true;
+            return tte;
+        }
+
+        if (EntryValue(&entry) < replaceValue)
+            replace = tte,
+            replaceValue = EntryValue(&entry);
+    }
+
+    *ttHit = false;
+    return replace;
 }
 
 // Store an entry in the transposition table
@@ -52,27 +107,40 @@ void StoreTTEntry(TTEntry *tte, const Key key,
     assert(ValidBound(bound));
     assert(ValidScore(score));
 
+    const uint16_t key16 = key >> 48;
+    const TTEntry old = Load(tte);
+    const bool samePos = EntryKey(&old) == key16;
+
     // Store new data unless it would overwrite data about the same
-    // position searched to a higher depth.
-    if (key != tte->key || depth >= tte->depth || bound == BOUND_EXACT)
-        tte->key   = key,
-        tte->move  = move,
-        tte->score = score,
-        tte->depth = depth,
-        tte->bound = bound;
+    // position searched to a higher depth in the current search.
+    if (!samePos || depth + 4 >= old.depth || bound == BOUND_EXACT || Age(&old)) {
+
+        TTEntry entry = {
+            .move     = move || !samePos ? move : old.move,
+            .score    = score,
+            .depth    = depth,
+            .genBound = TT.generation | bound
+        };
+        entry.key = key16 ^ Checksum(&entry);
+
+        memcpy(tte, &entry, sizeof(TTEntry));
+    }
 }
 
-// Estimates the load factor of the transposition table (1 = 0.1%)
+// Estimates the load factor of the transposition table (1 = 0.1%),
+// counting only entries written during the current search
 int HashFull() {
 
     int used = 0;
-    const int samples = 1000;
+    const int samples = 1000 / BUCKET_SIZE;
 
     for (int i = 0; i < samples; ++i)
-        if (TT.table[i].move != NOMOVE)
-            used++;
+        for (int j = 0; j < BUCKET_SIZE; ++j) {
+            TTEntry entry = Load(&TT.table[i].entry[j]);
+            used += Bound(&entry) != BOUND_NONE && !Age(&entry);
+        }
 
-    return used / (samples / 1000);
+    return used * 1000 / (samples * BUCKET_SIZE);
 }
 
 static void *ThreadClearTT(void *voidThread) {
@@ -81,15 +149,16 @@ static void *ThreadClearTT(void *voidThread) {
     int index = thread->index;
     int count = thread->count;
 
-    // Logic for dividing the work taken from CFish
+    // Logic for dividing the work taken from CFish. With NUMA pinning
+    // this first touch also spreads the pages across the nodes.
     uint64_t twoMB  = 2 * 1024 * 1024;
-    uint64_t size   = TT.count * sizeof(TTEntry);
+    uint64_t size   = TT.count * sizeof(TTBucket);
     uint64_t slice  = (size + count - 1) / count;
     uint64_t blocks = (slice + twoMB - 1) / twoMB;
     uint64_t begin  = MIN(size, index * blocks * twoMB);
     uint64_t end    = MIN(size, begin + blocks * twoMB);
 
-    memset(TT.table + begin / sizeof(TTEntry), 0, end - begin);
+    memset(TT.table + begin / sizeof(TTBucket), 0, end - begin);
 
     return NULL;
 }
@@ -98,6 +167,7 @@ static void *ThreadClearTT(void *voidThread) {
 void ClearTT() {
     if (!TT.dirty) return;
     RunWithAllThreads(ThreadClearTT);
+    TT.generation = 0;
     TT.dirty = false;
 }
 
@@ -117,12 +187,12 @@ void InitTT() {
 #if defined(__linux__)
     // Align on 2MB boundaries and request Huge Pages
     TT.mem = aligned_alloc(2 * 1024 * 1024, size);
-    TT.table = (TTEntry *)TT.mem;
+    TT.table = (TTBucket *)TT.mem;
     madvise(TT.table, size, MADV_HUGEPAGE);
 #else
     // Align on cache line
     TT.mem = malloc(size + 64 - 1);
-    TT.table = (TTEntry *)(((uintptr_t)TT.mem + 64 - 1) & ~(64 - 1));
+    TT.table = (TTBucket *)(((uintptr_t)TT.mem + 64 - 1) & ~(64 - 1));
 #endif
 
     // Allocation failed
@@ -132,7 +202,7 @@ void InitTT() {
     }
 
     TT.currentMB = TT.requestedMB;
-    TT.count = size / sizeof(TTEntry);
+    TT.count = size / sizeof(TTBucket);
 
     // Zero out the memory
     TT.dirty = true;
@@ -18,44 +18,67 @@
 
 #pragma once
 
+#include <string.h>
+
 #include "threads.h"
 #include "types.h"
 
 
 // 2MB hash is a reasonable expectation.
 #define MINHASH 2
-// 65536MB = 2^32 * 16B / (1024 * 1024)
+// 262144MB = 2^32 * 64B / (1024 * 1024)
 // is the limit current indexing is able
-// to use given the 16B size of entries
-#define MAXHASH 65536
+// to use given the 64B size of buckets
+#define MAXHASH 262144
 #define DEFAULTHASH 32
 
+#define BUCKET_SIZE 8
+
+// The low 2 bits of genBound hold the bound, the rest the generation
+#define GEN_STEP  4
+#define GEN_MASK  0xFC
+#define GEN_CYCLE 256
+
 #define ValidBound(bound) (bound >= BOUND_UPPER && bound <= BOUND_EXACT)
 #define ValidScore(score) (score >= -MATE && score <= MATE)
 
 
 enum { BOUND_NONE, BOUND_UPPER, BOUND_LOWER, BOUND_EXACT };
 
+// The key is stored xored with the rest of the entry, so an entry
+// torn by concurrent writes from other threads fails verification
 typedef struct {
-    Key key;
-    Move move;
+    uint16_t key;
+    uint16_t move;
     int16_t score;
     uint8_t depth;
-    uint8_t bound;
+    uint8_t genBound;
 } TTEntry;
 
+typedef struct {
+    TTEntry entry[BUCKET_SIZE];
+} TTBucket;
+
 typedef struct {
     void *mem;
-    TTEntry *table;
+    TTBucket *table;
     uint64_t count;
     uint64_t currentMB;
     uint64_t requestedMB;
+    uint8_t generation;
     bool dirty;
 } TranspositionTable;
 
 
 extern TranspositionTable TT;
 
+// Simplified ABDADA, moves some thread is currently searching are marked
+// in a small table beside the TT so other threads can defer them
+#define SEARCHING_SIZE 32768
+
+extern bool UseABDADA;
+extern volatile Key Searching[SEARCHING_SIZE];
+
 
 // Mate scores are stored as mate in 0 as they depend on the current ply
 INLINE int ScoreToTT (const int score, const uint8_t ply) {
@@ -71,17 +94,53 @@ INLINE int ScoreFromTT (const int score, const uint8_t ply) {
                                  : score;
 }
 
-INLINE TTEntry *GetEntry(Key key) {
+INLINE TTBucket *GetBucket(Key key) {
     // https://lemire.me/blog/2016/06/27/a-fast-alternative-to-the-modulo-reduction/
     return &TT.table[((uint32_t)key * (uint64_t)TT.count) >> 32];
 }
 
+INLINE void PrefetchTTBucket(Key key) {
+    __builtin_prefetch(GetBucket(key));
+}
+
+INLINE int Bound(const TTEntry *tte) {
+    return tte->genBound & ~GEN_MASK;
+}
+
+// Number of searches since the entry was written
+INLINE int Age(const TTEntry *tte) {
+    return ((GEN_CYCLE + TT.generation - (tte->genBound & GEN_MASK)) & GEN_MASK) / GEN_STEP;
+}
+
+INLINE void NewSearchTT() {
+    TT.generation += GEN_STEP;
+    memset((void *)Searching, 0, sizeof(Searching));
+}
+
+INLINE Key MoveKey(Key key, Move move) {
+    return key ^ (move * 0x9E3779B97F4A7C15ull);
+}
+
+INLINE bool IsBeingSearched(Key moveKey) {
+    return Searching[moveKey & (SEARCHING_SIZE - 1)] == moveKey;
+}
+
+INLINE void StartSearching(Key moveKey) {
+    volatile Key *slot = &Searching[moveKey & (SEARCHING_SIZE - 1)];
+    if (!*slot) *slot = moveKey;
+}
+
+INLINE void FinishSearching(Key moveKey) {
+    volatile Key *slot = &Searching[moveKey & (SEARCHING_SIZE - 1)];
+    if (*slot == moveKey) *slot = 0;
+}
+
 INLINE void RequestTTSize(int megabytes) {
     TT.requestedMB = megabytes;
     puts("info string Hash will resize after next 'isready'.");
 }
 
-TTEntry* ProbeTT(Key key, bool *ttHit);
+TTEntry* ProbeTT(Key key, TTEntry *ttData, bool *ttHit);
 void StoreTTEntry(TTEntry *tte, Key key, Move move, int score, Depth depth, int bound);
 int HashFull();
 void ClearTT();
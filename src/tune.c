@@ -0,0 +1,454 @@
+/*
+  Weixx is a UAI compliant ataxx engine.
+  Copyright (C) 2020  Terje Kirstihagen
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifdef DEV
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bitboard.h"
+#include "board.h"
+#include "evaluate.h"
+#include "makemove.h"
+#include "movegen.h"
+#include "movepicker.h"
+#include "threads.h"
+#include "time.h"
+#include "tune.h"
+
+
+// Texel tuning of the evaluation weights. Each position is resolved by
+// a quiescence search, then the weights are fit so that the evaluation of
+// the leaf predicts the game result, minimizing the mean squared error of
+// sigmoid(K * eval / 400) with K fitted first to the untuned weights.
+
+#define ResolveMaxPly 8
+
+// Adam
+#define Beta1   0.9
+#define Beta2   0.999
+#define Epsilon 1e-8
+
+// The dense features, the terms and the side to move
+#define TEMPO    TERM_NB
+#define DENSE_NB (TERM_NB + 1)
+
+#define Lanes 16
+
+
+static const char *TermIds[TERM_NB] = {
+    "MATERIAL", "SINGLE_MOBILITY", "DOUBLE_MOBILITY", "FRONTIER", "HOLES", "SAFE"
+};
+
+
+// Positions stored column-wise, so the sweeps over the dense features
+// vectorize across positions
+typedef struct Dataset {
+    int count;
+    float *dense[DENSE_NB];
+    int16_t (*patterns)[PATTERN_COUNT]; // Signed pattern parameter + 1, or 0
+    float *result;                      // From white's point of view
+    float *scratch;                     // Evaluation, then its error gradient
+} Dataset;
+
+static Dataset data;
+
+// Dense weights followed by one weight per canonical pattern
+static float *params;
+static int paramCount;
+static uint16_t *paramPattern;
+static int16_t *patternParam;
+
+static double K;
+static bool withGradient;
+static double *gradients; // One set per thread
+static double *errors;
+
+
+// Sum of x[i] * y[i] kept in independent lanes so it vectorizes
+static double Dot(const float *x, const float *y, const int begin, const int end) {
+
+    float lanes[Lanes] = { 0 };
+    int i = begin;
+
+    for (; i + Lanes <= end; i += Lanes)
+        for (int j = 0; j < Lanes; ++j)
+            lanes[j] += x[i+j] * y[i+j];
+
+    double sum = 0;
+    for (int j = 0; j < Lanes; ++j)
+        sum += lanes[j];
+    for (; i < end; ++i)
+        sum += x[i] * y[i];
+
+    return sum;
+}
+
+// Evaluates a thread's share of the positions under the current weights,
+// summing the error and optionally its gradient
+static void *Sweep(void *voidThread) {
+
+    Thread *thread = voidThread;
+    const int begin = (int64_t)data.count *  thread->index      / thread->count;
+    const int end   = (int64_t)data.count * (thread->index + 1) / thread->count;
+
+    float *eval = data.scratch;
+
+    for (int i = begin; i < end; ++i)
+        eval[i] = 0;
+
+    for (int f = 0; f < DENSE_NB; ++f) {
+        const float weight = params[f], *x = data.dense[f];
+        for (int i = begin; i < end; ++i)
+            eval[i] += weight * x[i];
+    }
+
+    for (int i = begin; i < end; ++i)
+        for (int k = 0; k < PATTERN_COUNT; ++k) {
+            int p = data.patterns[i][k];
+            eval[i] += p > 0 ?  params[DENSE_NB + p - 1]
+                     : p < 0 ? -params[DENSE_NB - p - 1]
+                             : 0;
+        }
+
+    // Replace each evaluation by the derivative of its error
+    double error = 0;
+    for (int i = begin; i < end; ++i) {
+        float s = 1.0f / (1.0f + expf(-K * eval[i] / 400));
+        float e = s - data.result[i];
+        error += e * e;
+        eval[i] = e * s * (1 - s);
+    }
+    errors[thread->index] = error;
+
+    if (!withGradient)
+        return NULL;
+
+    double *gradient = gradients + (size_t)thread->index * paramCount;
+    memset(gradient, 0, paramCount * sizeof(double));
+
+    for (int f = 0; f < DENSE_NB; ++f)
+        gradient[f] = Dot(eval, data.dense[f], begin, end);
+
+    for (int i = begin; i < end; ++i)
+        for (int k = 0; k < PATTERN_COUNT; ++k) {
+            int p = data.patterns[i][k];
+            if      (p > 0) gradient[DENSE_NB + p - 1] += eval[i];
+            else if (p < 0) gradient[DENSE_NB - p - 1] -= eval[i];
+        }
+
+    return NULL;
+}
+
+// Mean squared error over all positions, leaving the summed
+// gradient in the first thread's buffer if asked for
+static double Error(const bool gradient) {
+
+    withGradient = gradient;
+    RunWithAllThreads(Sweep);
+
+    double error = 0;
+    for (int t = 0; t < threads->count; ++t)
+        error += errors[t];
+
+    if (gradient)
+        for (int t = 1; t < threads->count; ++t)
+            for (int p = 0; p < paramCount; ++p)
+                gradients[p] += gradients[(size_t)t * paramCount + p];
+
+    return error / data.count;
+}
+
+// Golden section search for the K that best fits the current weights
+static void FitK() {
+
+    const double phi = (sqrt(5) - 1) / 2;
+    double low = 0, high = 10;
+
+    for (int i = 0; i < 40; ++i) {
+        double k1 = high - phi * (high - low);
+        double k2 = low  + phi * (high - low);
+        K = k1; double e1 = Error(false);
+        K = k2; double e2 = Error(false);
+        if (e1 < e2) high = k2;
+        else         low  = k1;
+    }
+
+    K = (low + high) / 2;
+}
+
+// Quiescence search over the high yield singles the engine itself
+// searches in quiescence, returning the position the score came from
+static int Resolve(const Position *pos, const Patterns *patterns, int alpha, const int beta, const int qply, Position *leaf) {
+
+    *leaf = *pos;
+
+    if (!colorBB(sideToMove) || pieceBB == full)
+        return 0;
+
+    int eval = EvalPosition(pos, patterns, NULL);
+
+    if (qply >= ResolveMaxPly || eval >= beta)
+        return eval;
+
+    alpha = MAX(alpha, eval);
+
+    MoveList list = { 0 };
+    GenHighYieldSingles(pos, &list, QSMinFlips);
+
+    for (int i = 0; i < list.count; ++i) {
+
+        Position next = *pos, nextLeaf;
+        Patterns nextPatterns;
+        MakeMove(&next, list.moves[i].move);
+        UpdatePatterns(&nextPatterns, patterns, pos, list.moves[i].move);
+
+        int score = -Resolve(&next, &nextPatterns, -beta, -alpha, qply + 1, &nextLeaf);
+
+        if (score > alpha) {
+            alpha = score;
+            *leaf = nextLeaf;
+            if (score >= beta)
+                break;
+        }
+    }
+
+    return alpha;
+}
+
+// Reads the result from x's point of view, as [1.0], [0.5], [0.0]
+// or 1-0, 0-1, 1/2-1/2
+static bool ParseResult(const char *line, float *result) {
+
+    const char *bracket = strchr(line, '[');
+
+    return bracket               ? (*result = atof(bracket + 1), true)
+         : strstr(line, "1/2-1/2") ? (*result = 0.5, true)
+         : strstr(line, "1-0")     ? (*result = 1.0, true)
+         : strstr(line, "0-1")     ? (*result = 0.0, true)
+                                   : false;
+}
+
+// Maps each canonical pattern to a parameter
+static void InitParams() {
+
+    int16_t classParam[PATTERN_NB];
+    memset(classParam, -1, sizeof(classParam));
+
+    patternParam = calloc(PATTERN_NB, sizeof(int16_t));
+    paramPattern = calloc(PATTERN_NB, sizeof(uint16_t));
+    paramCount = DENSE_NB;
+
+    for (int index = 0; index < PATTERN_NB; ++index) {
+
+        int c = PatternCanonical(index);
+        int canonical = abs(c) - 1;
+
+        if (c && classParam[canonical] < 0) {
+            classParam[canonical] = paramCount - DENSE_NB;
+            paramPattern[paramCount++ - DENSE_NB] = canonical;
+        }
+
+        patternParam[index] = c > 0 ?   classParam[canonical] + 1
+                            : c < 0 ? -(classParam[canonical] + 1)
+                                    : 0;
+    }
+
+    params = calloc(paramCount, sizeof(float));
+
+    for (int term = 0; term < TERM_NB; ++term)
+        params[term] = TermWeights[term];
+    params[TEMPO] = Tempo;
+    for (int p = DENSE_NB; p < paramCount; ++p)
+        params[p] = PatternWeights[paramPattern[p - DENSE_NB]];
+}
+
+// Loads and resolves the positions, skipping any that can't be used
+static bool LoadDataset(const char *path) {
+
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        printf("info string Unable to open %s\n", path);
+        return false;
+    }
+
+    char line[256];
+    int capacity = 0;
+    while (fgets(line, sizeof(line), file))
+        capacity++;
+    rewind(file);
+
+    for (int f = 0; f < DENSE_NB; ++f)
+        data.dense[f] = malloc(capacity * sizeof(float));
+    data.patterns = malloc(capacity * sizeof(*data.patterns));
+    data.result   = malloc(capacity * sizeof(float));
+    data.scratch  = malloc(capacity * sizeof(float));
+
+    Game game;
+    char board[128], stm[8];
+    int rule50, moves, skipped = 0;
+
+    while (fgets(line, sizeof(line), file)) {
+
+        float result;
+
+        // Needs a full fen without gaps, and a result
+        if (   sscanf(line, "%127s %7s %d %d", board, stm, &rule50, &moves) != 4
+            || strchr(board, '-')
+            || !ParseResult(line, &result)) {
+            skipped++;
+            continue;
+        }
+
+        ParseFen(line, &game);
+
+        Patterns patterns;
+        RefreshPatterns(&patterns, &game.pos);
+
+        Position leaf, *pos = &leaf;
+        Resolve(&game.pos, &patterns, -INFINITE, INFINITE, 0, &leaf);
+
+        if (!colorBB(sideToMove) || pieceBB == full) {
+            skipped++;
+            continue;
+        }
+
+        int counts[COLOR_NB][TERM_NB];
+        CountTerms(pos, counts);
+        RefreshPatterns(&patterns, pos);
+
+        const int i = data.count++;
+
+        for (int term = 0; term < TERM_NB; ++term)
+            data.dense[term][i] = counts[WHITE][term] - counts[BLACK][term];
+        data.dense[TEMPO][i] = sideToMove == WHITE ? 1 : -1;
+
+        for (int k = 0; k < PATTERN_COUNT; ++k)
+            data.patterns[i][k] = patternParam[patterns.index[k]];
+
+        data.result[i] = 1 - result;
+    }
+
+    fclose(file);
+
+    printf("info string Loaded %d positions, skipped %d\n", data.count, skipped);
+    fflush(stdout);
+
+    return data.count > 0;
+}
+
+// Writes the weights in the format of weights.h
+static void WriteWeights(const char *path) {
+
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        printf("info string Unable to write %s\n", path);
+        return;
+    }
+
+    fprintf(file, "// Evaluation weights, in the format written by the dev 'tune' command\n\n");
+    fprintf(file, "#pragma once\n\n#include \"evaluate.h\"\n\n\n");
+    fprintf(file, "// Bonus for being the side to move\n");
+    fprintf(file, "const int Tempo = %d;\n\n", (int)lroundf(params[TEMPO]));
+    fprintf(file, "// Weight of each term per stone or square\n");
+    fprintf(file, "const int TermWeights[TERM_NB] = {\n");
+    for (int term = 0; term < TERM_NB; ++term)
+        fprintf(file, "    [%s]%*s= %4d,\n", TermIds[term], (int)(16 - strlen(TermIds[term])), "", (int)lroundf(params[term]));
+    fprintf(file, "};\n\n");
+    fprintf(file, "// Weights of canonical 3x3 patterns from white's point of view,\n");
+    fprintf(file, "// ended by the empty pattern\n");
+    fprintf(file, "const PatternWeight TunedPatterns[] = {\n");
+    for (int p = DENSE_NB; p < paramCount; ++p)
+        if (lroundf(params[p]))
+            fprintf(file, "    { %5d, %4d },\n", paramPattern[p - DENSE_NB], (int)lroundf(params[p]));
+    fprintf(file, "    { 0, 0 }\n};\n");
+
+    fclose(file);
+}
+
+// tune <dataset> [epochs] [learning rate] [output]
+void Tune(char *line) {
+
+    char path[256] = "", output[256] = "tuned.h";
+    int epochs = 1000;
+    double lr = 1.0;
+
+    sscanf(line, "tune %255s %d %lf %255s", path, &epochs, &lr, output);
+
+    TimePoint start = Now();
+
+    InitParams();
+
+    if (!LoadDataset(path))
+        goto cleanup;
+
+    errors    = calloc(threads->count, sizeof(double));
+    gradients = calloc((size_t)threads->count * paramCount, sizeof(double));
+
+    FitK();
+    printf("info string K %.4f error %.6f\n", K, Error(false));
+    fflush(stdout);
+
+    double *m = calloc(paramCount, sizeof(double));
+    double *v = calloc(paramCount, sizeof(double));
+
+    for (int epoch = 1; epoch <= epochs; ++epoch) {
+
+        double error = Error(true);
+
+        // The gradient of the mean error with respect to each weight
+        const double scale = 2.0 * K / 400 / data.count;
+        const double c1 = 1 - pow(Beta1, epoch);
+        const double c2 = 1 - pow(Beta2, epoch);
+
+        for (int p = 0; p < paramCount; ++p) {
+            double g = gradients[p] * scale;
+            m[p] = Beta1 * m[p] + (1 - Beta1) * g;
+            v[p] = Beta2 * v[p] + (1 - Beta2) * g * g;
+            params[p] -= lr * (m[p] / c1) / (sqrt(v[p] / c2) + Epsilon);
+        }
+
+        if (epoch % 50 == 0 || epoch == epochs) {
+            printf("info string epoch %d error %.6f time %d\n", epoch, error, TimeSince(start));
+            fflush(stdout);
+            WriteWeights(output);
+        }
+    }
+
+    printf("info string Wrote %s\n", output);
+
+    free(m);
+    free(v);
+    free(errors);
+    free(gradients);
+
+cleanup:
+    for (int f = 0; f < DENSE_NB; ++f)
+        free(data.dense[f]);
+    free(data.patterns);
+    free(data.result);
+    free(data.scratch);
+    free(params);
+    free(patternParam);
+    free(paramPattern);
+    memset(&data, 0, sizeof(data));
+}
+
+#endif
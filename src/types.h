@@ -32,12 +32,11 @@
 #define INLINE static inline __attribute__((always_inline))
 #define CONSTR static __attribute__((constructor)) void
 
-#define lastMoveNullMove (!root && moveIsNull(history(-1).move))
-#define history(offset) (pos->gameHistory[pos->histPly + offset])
+#define lastMoveNullMove (!root && moveIsNull((ss-1)->move))
 
 #define colorBB(color) (pos->colorBB[(color)])
+#define pieceBB (colorBB(BLACK) | colorBB(WHITE))
 #define sideToMove (pos->stm)
-#define pieceOn(sq) (pos->board[sq])
 #define BB(sq) (1ull << sq)
 
 
@@ -16,19 +16,55 @@
   along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <math.h>
 #include <stdlib.h>
 
 #include "board.h"
 #include "makemove.h"
 #include "move.h"
+#include "movegen.h"
+#include "nnue.h"
+#include "numa.h"
 #include "search.h"
 #include "tests.h"
 #include "threads.h"
 #include "time.h"
 #include "transposition.h"
+#include "tune.h"
 #include "uai.h"
 
 
+// Parses the moves following 'searchmoves', up to the next keyword.
+// Illegal moves are dropped, and if none are left the search is not
+// restricted at all.
+static void ParseSearchMoves(const char *str, const Position *pos) {
+
+    char *ptr = strstr(str, "searchmoves");
+    if (!ptr) return;
+
+    char copy[INPUT_SIZE];
+    strcpy(copy, ptr + strlen("searchmoves"));
+
+    MoveList list;
+    GenAllMoves(pos, &list);
+
+    for (char *token = strtok(copy, " \n"); token; token = strtok(NULL, " \n")) {
+
+        bool isMove = !strcmp(token, "0000")
+                   || (   token[0] >= 'a' && token[0] <= 'g'
+                       && token[1] >= '1' && token[1] <= '7');
+        if (!isMove || Limits.searchMoveCount == 256) break;
+
+        const Move move = ParseMove(token);
+
+        for (int i = 0; i < list.count; ++i)
+            if (list.moves[i].move == move) {
+                Limits.searchMoves[Limits.searchMoveCount++] = move;
+                break;
+            }
+    }
+}
+
 // Parses the time controls
 static void ParseTimeControl(const char *str, const Color color) {
 
@@ -43,28 +79,36 @@ static void ParseTimeControl(const char *str, const Color color) {
     SetLimit(str, "movestogo", &Limits.movestogo);
     SetLimit(str, "movetime",  &Limits.movetime);
     SetLimit(str, "depth",     &Limits.depth);
+    SetLimit(str, "mate",      &Limits.mate);
+
+    char *nodes = strstr(str, "nodes");
+    if (nodes)
+        Limits.nodes = strtoull(nodes + strlen("nodes"), NULL, 10);
 
     Limits.timelimit = Limits.time || Limits.movetime;
     Limits.depth = Limits.depth ?: 100;
 }
 
 // Parses the given limits and creates a new thread to start the search
-INLINE void Go(Position *pos, const char *str) {
+INLINE void Go(Game *game, const char *str) {
     ABORT_SIGNAL = false;
     InitTT();
     TT.dirty = true;
-    ParseTimeControl(str, sideToMove);
-    StartMainThread(SearchPosition, pos);
+    ParseTimeControl(str, game->pos.stm);
+    ParseSearchMoves(str, &game->pos);
+    StartMainThread(SearchPosition, game);
 }
 
 // Parses a 'position' and sets up the board
-static void Pos(Position *pos, char *str) {
+static void Pos(Game *game, char *str) {
 
     #define IsFen (!strncmp(str, "position fen", 12))
 
+    Position *pos = &game->pos;
+
     // Set up original position. This will either be a
     // position given as FEN, or the normal start position
-    ParseFen(IsFen ? str + 13 : START_FEN, pos);
+    ParseFen(IsFen ? str + 13 : START_FEN, game);
 
     // Check if there are moves to be made from the initial position
     if ((str = strstr(str, "moves")) == NULL) return;
@@ -79,12 +123,28 @@ static void Pos(Position *pos, char *str) {
         // Keep track of how many moves have been played
         pos->gameMoves += sideToMove == WHITE;
 
-        // Reset histPly so long games don't go out of bounds of arrays
-        if (pos->rule50 == 0)
-            pos->histPly = 0;
+        // Add the new key to the ring
+        game->keys[++game->ply] = pos->key;
     }
+}
+
+// Restarts the workers pinned or unpinned, and reallocates the TT
+// at the next 'isready' so the pinned workers first touch its pages
+static void SetNumaPinning(bool pinning) {
+    NumaPinning = pinning;
+    InitThreads(threads->count);
+    TT.currentMB = 0;
+    printf("info string NUMA pinning %s, %d node(s) detected\n",
+           pinning ? "on" : "off", NumaNodeCount());
+}
 
-    pos->nodes = 0;
+// Loads a network from file and reports the result
+static void SetEvalFile(char *path) {
+    path[strcspn(path, "\r\n")] = '\0';
+    if (LoadNetwork(path))
+        printf("info string Loaded network %s\n", path);
+    else
+        printf("info string Failed to load network %s\n", path);
 }
 
 // Parses a 'setoption' and updates settings
@@ -95,9 +155,20 @@ static void SetOption(char *str) {
 
     #define OptionNameIs(name) (!strncmp(optionName, name, strlen(name)))
     #define IntValue           (atoi(optionValue))
-
-    if      (OptionNameIs("Hash"   )) RequestTTSize(IntValue);
-    else if (OptionNameIs("Threads")) InitThreads(IntValue);
+    #define BoolValue          (!strncmp(optionValue, "true", 4))
+
+    if      (OptionNameIs("Hash"      )) RequestTTSize(IntValue);
+    else if (OptionNameIs("Threads"   )) InitThreads(IntValue);
+    else if (OptionNameIs("NUMA"      )) SetNumaPinning(BoolValue);
+    else if (OptionNameIs("ABDADA"    )) UseABDADA = BoolValue;
+    else if (OptionNameIs("EvalCache" )) EvalCacheKB = IntValue, InitThreads(threads->count);
+    else if (OptionNameIs("UseNNUE"   )) UseNNUE   = BoolValue;
+    else if (OptionNameIs("EvalFile"  )) SetEvalFile(optionValue);
+#ifdef DEV
+    // Search parameters for tuning
+    else if (OptionNameIs("LMRBase"   )) LMRBase    = IntValue, InitReductions();
+    else if (OptionNameIs("LMRDivisor")) LMRDivisor = IntValue, InitReductions();
+#endif
     else puts("info string No such option.");
 
     fflush(stdout);
@@ -109,6 +180,15 @@ static void Info() {
     printf("id author Terje Kirstihagen\n");
     printf("option name Hash type spin default %d min %d max %d\n", DEFAULTHASH, MINHASH, MAXHASH);
     printf("option name Threads type spin default %d min %d max %d\n", 1, 1, 2048);
+    printf("option name NUMA type check default false\n");
+    printf("option name ABDADA type check default false\n");
+    printf("option name EvalCache type spin default %d min %d max %d\n", DEFAULT_EVAL_CACHE, 0, MAX_EVAL_CACHE);
+    printf("option name UseNNUE type check default false\n");
+    printf("option name EvalFile type string default <empty>\n");
+#ifdef DEV
+    printf("option name LMRBase type spin default %d min %d max %d\n", 75, 0, 500);
+    printf("option name LMRDivisor type spin default %d min %d max %d\n", 225, 50, 1000);
+#endif
     printf("uaiok\n"); fflush(stdout);
 }
 
@@ -142,30 +222,43 @@ static int HashInput(char *str) {
 }
 
 // Sets up the engine and follows UAI protocol commands
-int main() {
+int main(int argc, char **argv) {
+
+    InitReductions();
+    InitNuma();
+    InitNNUE();
+
+    // Benchmark
+    if (argc > 1 && strstr(argv[1], "bench")) {
+        Benchmark(argc, argv);
+        return 0;
+    }
 
     // Init engine
     InitThreads(1);
-    Position pos;
-    ParseFen(START_FEN, &pos);
+    Game game;
+    ParseFen(START_FEN, &game);
 
     // Input loop
     char str[INPUT_SIZE];
     while (GetInput(str)) {
         switch (HashInput(str)) {
-            case GO         : Go(&pos, str);  break;
-            case UAI        : Info();         break;
-            case ISREADY    : IsReady();      break;
-            case POSITION   : Pos(&pos, str); break;
-            case SETOPTION  : SetOption(str); break;
-            case UAINEWGAME : NewGame();      break;
-            case STOP       : Stop();         break;
-            case QUIT       : Stop();         return 0;
+            case GO         : Go(&game, str);        break;
+            case UAI        : Info();                break;
+            case ISREADY    : IsReady();             break;
+            case POSITION   : Pos(&game, str);       break;
+            case SETOPTION  : SetOption(str);        break;
+            case UAINEWGAME : NewGame();             break;
+            case STOP       : Stop();                break;
+            case QUIT       : Stop();                return 0;
 #ifdef DEV
             // Non-UAI commands
-            case EVAL       : PrintEval(&pos);  break;
-            case PRINT      : PrintBoard(&pos); break;
-            case PERFT      : Perft(str);       break;
+            case EVAL       : PrintEval(&game.pos);  break;
+            case PRINT      : PrintBoard(&game.pos); break;
+            case PERFT      : Perft(str);            break;
+            case MPCHECK    : MPCheck(str);          break;
+            case PREFETCH   : PrefetchBench(str);    break;
+            case TUNE       : Tune(str);             break;
 #endif
         }
     }
@@ -180,7 +273,6 @@ INLINE int MateScore(const int score) {
 // Print thinking
 void PrintThinking(const Thread *thread, Stack *ss, int score, int alpha, int beta) {
 
-    const Position *pos = &thread->pos;
     const PV *pv = &ss->pv;
 
     // Determine whether we have a centipawn or mate score
@@ -199,14 +291,10 @@ void PrintThinking(const Thread *thread, Stack *ss, int score, int alpha, int be
     int hashFull      = HashFull();
     int nps           = (int)(1000 * nodes / (elapsed + 1));
 
-    Depth seldepth = MAX_PLY;
-    for (; seldepth > 0; --seldepth)
-        if (history(seldepth-1).key != 0) break;
-
     // Basic info
     printf("info depth %d seldepth %d score %s %d%s time %" PRId64
            " nodes %" PRIu64 " nps %d hashfull %d pv",
-            thread->depth, seldepth, type, score, bound, elapsed,
+            thread->depth, thread->seldepth, type, score, bound, elapsed,
             nodes, nps, hashFull);
 
     // Principal variation
@@ -217,6 +305,35 @@ void PrintThinking(const Thread *thread, Stack *ss, int score, int alpha, int be
     fflush(stdout);
 }
 
+// Print statistics of the search
+void PrintSearchStats() {
+
+    SearchStats stats = TotalStats();
+    uint64_t nodes  = stats.nodes;
+    uint64_t qnodes = stats.qnodes;
+    uint64_t probes = stats.ttProbes;
+    uint64_t hits   = stats.ttHits;
+
+    printf("info string qnodes %" PRIu64 " share %.1f%%\n",
+            qnodes, 100.0 * qnodes / (nodes + !nodes));
+
+    printf("info string tthits %" PRIu64 " ttprobes %" PRIu64 " hitrate %.1f%%\n",
+            hits, probes, 100.0 * hits / (probes + !probes));
+
+    // The eval caches keep their own counters
+    uint64_t evalProbes = 0, evalHits = 0;
+    for (int i = 0; i < threads->count; ++i)
+        evalProbes += threads[i].evalCache.probes,
+        evalHits   += threads[i].evalCache.hits;
+
+    printf("info string evalhits %" PRIu64 " evalprobes %" PRIu64 " hitrate %.1f%%\n",
+            evalHits, evalProbes, 100.0 * evalHits / (evalProbes + !evalProbes));
+
+    // Effective branching factor of the completed iterations
+    if (threads->completedDepth)
+        printf("info string ebf %.2f\n", pow(nodes, 1.0 / threads->completedDepth));
+}
+
 // Print conclusion of search
 void PrintConclusion(const Thread *thread) {
     printf("bestmove %s", MoveToStr(thread->bestMove));
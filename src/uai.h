@@ -43,6 +43,9 @@ enum InputCommands {
     EVAL        = 26,
     PRINT       = 112,
     PERFT       = 116,
+    MPCHECK     = 123,
+    PREFETCH    = 19,
+    TUNE        = 14,
 };
 
 
@@ -67,4 +70,5 @@ INLINE void SetLimit(const char *str, const char *token, int *limit) {
 }
 
 void PrintThinking(const Thread *thread, Stack *ss, int score, int alpha, int beta);
+void PrintSearchStats();
 void PrintConclusion(const Thread *thread);
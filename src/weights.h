@@ -0,0 +1,1450 @@
+/*
+  Weixx is a UAI compliant ataxx engine.
+  Copyright (C) 2020  Terje Kirstihagen
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// Evaluation weights, in the format written by the dev 'tune' command
+
+#pragma once
+
+#include "evaluate.h"
+
+
+// Bonus for being the side to move
+const int Tempo = 331;
+
+// Weight of each term per stone or square
+const int TermWeights[TERM_NB] = {
+    [MATERIAL]        =  301,
+    [SINGLE_MOBILITY] =   -3,
+    [DOUBLE_MOBILITY] =    4,
+    [FRONTIER]        = -147,
+    [HOLES]           =  -21,
+    [SAFE]            =   73,
+};
+
+// Weights of canonical 3x3 patterns from white's point of view,
+// ended by the empty pattern
+const PatternWeight TunedPatterns[] = {
+    {     1,    5 },
+    {     3,   24 },
+    {     4,   18 },
+    {     5,   38 },
+    {    10,  -35 },
+    {    13,   72 },
+    {    14,   30 },
+    {    16,   14 },
+    {    30,   -5 },
+    {    31,   39 },
+    {    32,   51 },
+    {    34,  -65 },
+    {    36,   33 },
+    {    37,   51 },
+    {    38,  -93 },
+    {    39,   70 },
+    {    40,   79 },
+    {    41,  -22 },
+    {    42,  -19 },
+    {    43, -117 },
+    {    44,   63 },
+    {    45,  -13 },
+    {    46,  -73 },
+    {    47, -148 },
+    {    48,   67 },
+    {    49,  -11 },
+    {    50,  -30 },
+    {    51,   59 },
+    {    52,  -63 },
+    {    53,   12 },
+    {    81,   -5 },
+    {    82,  -51 },
+    {    83, -184 },
+    {    84,  -35 },
+    {    85,    7 },
+    {    86,  -36 },
+    {    87, -198 },
+    {    88,  168 },
+    {    89, -124 },
+    {    91,  -74 },
+    {    92,  -33 },
+    {    94,  -35 },
+    {    95,   -7 },
+    {    97,  252 },
+    {    98, -114 },
+    {   101, -342 },
+    {   104,    7 },
+    {   107, -190 },
+    {   111,  -28 },
+    {   112,   25 },
+    {   113,   -1 },
+    {   114,  126 },
+    {   115,  -20 },
+    {   116,  -63 },
+    {   117,  -98 },
+    {   118,   70 },
+    {   119, -235 },
+    {   120,   32 },
+    {   121,  -38 },
+    {   122,   37 },
+    {   123,  265 },
+    {   124,   15 },
+    {   125,  -65 },
+    {   126, -108 },
+    {   127,  -91 },
+    {   128,   31 },
+    {   129,  124 },
+    {   130,  -45 },
+    {   131,  -76 },
+    {   132, -126 },
+    {   133, -157 },
+    {   134,  -96 },
+    {   141, -162 },
+    {   142, -150 },
+    {   143,  -14 },
+    {   144,  -76 },
+    {   145, -160 },
+    {   146, -152 },
+    {   147,   17 },
+    {   148,   88 },
+    {   149,   99 },
+    {   150, -286 },
+    {   151,   23 },
+    {   152,  121 },
+    {   153,  198 },
+    {   154,   -8 },
+    {   155,   91 },
+    {   156,  266 },
+    {   157,  -84 },
+    {   158,   74 },
+    {   159, -133 },
+    {   160,  254 },
+    {   161,  -38 },
+    {   270,  243 },
+    {   271,  136 },
+    {   272,  -24 },
+    {   273,  156 },
+    {   274,  157 },
+    {   275,  272 },
+    {   276,  165 },
+    {   277,   32 },
+    {   278,   43 },
+    {   280,  147 },
+    {   281,   84 },
+    {   283,  -12 },
+    {   284,  276 },
+    {   286,   71 },
+    {   287,    7 },
+    {   290,  164 },
+    {   293,  330 },
+    {   296,  165 },
+    {   298, -216 },
+    {   299,   -4 },
+    {   300,    7 },
+    {   302,   -8 },
+    {   304,  189 },
+    {   305,  132 },
+    {   307,   -4 },
+    {   310,   23 },
+    {   311,   88 },
+    {   313,  -37 },
+    {   319,   21 },
+    {   351,  209 },
+    {   352,   77 },
+    {   353,   13 },
+    {   354,  138 },
+    {   356,  -82 },
+    {   357,  201 },
+    {   358,  -76 },
+    {   359,   88 },
+    {   361,  218 },
+    {   362,   67 },
+    {   364, -102 },
+    {   365, -107 },
+    {   367, -181 },
+    {   368, -202 },
+    {   371,  181 },
+    {   374, -153 },
+    {   377, -100 },
+    {   378,  261 },
+    {   379,  -31 },
+    {   380,  123 },
+    {   381,  192 },
+    {   382,   89 },
+    {   383,  -68 },
+    {   384,  220 },
+    {   385, -141 },
+    {   386,  214 },
+    {   387, -101 },
+    {   388,  156 },
+    {   389,   30 },
+    {   390,   38 },
+    {   391,  169 },
+    {   392,   56 },
+    {   393,  -57 },
+    {   394,  -19 },
+    {   395,  -32 },
+    {   396, -114 },
+    {   397,  176 },
+    {   398,   78 },
+    {   399,  169 },
+    {   400,  111 },
+    {   401,   38 },
+    {   402,   98 },
+    {   403, -125 },
+    {   404,  -54 },
+    {   432, -151 },
+    {   433,  308 },
+    {   434,   74 },
+    {   435,   64 },
+    {   436,  151 },
+    {   437,   27 },
+    {   438, -235 },
+    {   439, -202 },
+    {   440,  -14 },
+    {   442,   15 },
+    {   443,  -93 },
+    {   445,   63 },
+    {   446,   90 },
+    {   448,   62 },
+    {   449, -199 },
+    {   452,  -70 },
+    {   455, -156 },
+    {   458, -119 },
+    {   738,    4 },
+    {   739, -143 },
+    {   740,   46 },
+    {   741,   25 },
+    {   742,  200 },
+    {   743,   73 },
+    {   744,  -49 },
+    {   745,   16 },
+    {   746,  -27 },
+    {   748,   44 },
+    {   750,   94 },
+    {   751,  119 },
+    {   752,  353 },
+    {   753,    2 },
+    {   754,   92 },
+    {   755,  -73 },
+    {   768,  105 },
+    {   769,  197 },
+    {   770,   49 },
+    {   771,  -50 },
+    {   772, -116 },
+    {   773,  128 },
+    {   777,  155 },
+    {   778,    9 },
+    {   779,  -20 },
+    {   781,   15 },
+    {   798, -239 },
+    {   799,  -92 },
+    {   800,  -56 },
+    {   805,  -99 },
+    {   819, -116 },
+    {   820,  -76 },
+    {   821,   48 },
+    {   822,   19 },
+    {   823,   78 },
+    {   824,  -24 },
+    {   825,  -56 },
+    {   826,  197 },
+    {   827,   19 },
+    {   828,  -87 },
+    {   829, -140 },
+    {   830,  163 },
+    {   831,   28 },
+    {   832,  -23 },
+    {   833,  -59 },
+    {   834, -118 },
+    {   835, -122 },
+    {   836,  -87 },
+    {   849,    1 },
+    {   850,  -51 },
+    {   851,  187 },
+    {   852,  107 },
+    {   853,  -63 },
+    {   854,   50 },
+    {   855,  165 },
+    {   856,  121 },
+    {   857,    8 },
+    {   858,   22 },
+    {   859,   -5 },
+    {   860,   87 },
+    {   861,  -56 },
+    {   862,  -45 },
+    {   863,  102 },
+    {   879,  148 },
+    {   880,  -25 },
+    {   881, -270 },
+    {   882,  278 },
+    {   883, -117 },
+    {   884, -127 },
+    {   885,  225 },
+    {   886,  169 },
+    {   887,   64 },
+    {   888,  -27 },
+    {   889,  208 },
+    {   890,  -92 },
+    {   900,    3 },
+    {   901,  -26 },
+    {   902,   47 },
+    {   903,  -22 },
+    {   904,  100 },
+    {   905,  217 },
+    {   906, -170 },
+    {   907,  -61 },
+    {   908, -204 },
+    {   930,   48 },
+    {   931,   -7 },
+    {   932, -162 },
+    {   933,  238 },
+    {   934,   24 },
+    {   935,   50 },
+    {   960, -237 },
+    {   961,  219 },
+    {   962,  -31 },
+    {   973,    4 },
+    {   974,  180 },
+    {   975,  -63 },
+    {   976,  186 },
+    {   977,  -78 },
+    {   978,   55 },
+    {   979,   84 },
+    {   980,  130 },
+    {   982,   27 },
+    {   983,  268 },
+    {   984,   55 },
+    {   985,  130 },
+    {   986,  -13 },
+    {   987,  108 },
+    {   988, -168 },
+    {   989,  -48 },
+    {   991,   29 },
+    {   992,  216 },
+    {   993,  -96 },
+    {   994, -181 },
+    {   995, -101 },
+    {   996,  165 },
+    {   997,  225 },
+    {   998,  -73 },
+    {  1000,   55 },
+    {  1001, -118 },
+    {  1002,  184 },
+    {  1003,   34 },
+    {  1004,   95 },
+    {  1005,  103 },
+    {  1006, -209 },
+    {  1007,  -73 },
+    {  1008,  241 },
+    {  1009,    1 },
+    {  1010,  -66 },
+    {  1011,  168 },
+    {  1012,   87 },
+    {  1013,  290 },
+    {  1014,   69 },
+    {  1015,  173 },
+    {  1016,  -69 },
+    {  1017,  -31 },
+    {  1018,  335 },
+    {  1019,  257 },
+    {  1020,  165 },
+    {  1021,  189 },
+    {  1022,   60 },
+    {  1023,  207 },
+    {  1024,   33 },
+    {  1025,   -7 },
+    {  1027,  321 },
+    {  1028,  -24 },
+    {  1029,  107 },
+    {  1030,  214 },
+    {  1031,  -43 },
+    {  1032,   39 },
+    {  1033,  156 },
+    {  1034,  -18 },
+    {  1035,  -35 },
+    {  1036,  155 },
+    {  1037, -108 },
+    {  1038,   95 },
+    {  1039,  147 },
+    {  1040,   -3 },
+    {  1041, -273 },
+    {  1042,  -29 },
+    {  1043, -220 },
+    {  1045,  -96 },
+    {  1046, -144 },
+    {  1047, -133 },
+    {  1048,  204 },
+    {  1049,  -41 },
+    {  1050,   50 },
+    {  1051, -149 },
+    {  1052,  -51 },
+    {  1054,  -59 },
+    {  1055, -207 },
+    {  1056,   -8 },
+    {  1057,  189 },
+    {  1058, -141 },
+    {  1059,   53 },
+    {  1060, -128 },
+    {  1061, -193 },
+    {  1063,   50 },
+    {  1064, -251 },
+    {  1065,  -52 },
+    {  1066,  -61 },
+    {  1067,  -14 },
+    {  1068,   -6 },
+    {  1069, -194 },
+    {  1070, -148 },
+    {  1072, -225 },
+    {  1073,  222 },
+    {  1074,  -92 },
+    {  1075,   16 },
+    {  1076,  -36 },
+    {  1077,  -90 },
+    {  1078,  263 },
+    {  1079,   45 },
+    {  1081,   99 },
+    {  1082,  -30 },
+    {  1083,   35 },
+    {  1084,   10 },
+    {  1085,   44 },
+    {  1086,  192 },
+    {  1087,   19 },
+    {  1088,  155 },
+    {  1089,  139 },
+    {  1090,  229 },
+    {  1091,   96 },
+    {  1092,  158 },
+    {  1093,  -28 },
+    {  1094,   20 },
+    {  1095,   81 },
+    {  1096,   -6 },
+    {  1097,  -52 },
+    {  1098,   32 },
+    {  1099,   61 },
+    {  1100,  205 },
+    {  1101,   94 },
+    {  1102,    4 },
+    {  1103,  157 },
+    {  1104,   52 },
+    {  1105,  -49 },
+    {  1106,    9 },
+    {  1108,  178 },
+    {  1109,   71 },
+    {  1110,  -62 },
+    {  1111,  204 },
+    {  1112,   95 },
+    {  1113,  -43 },
+    {  1114,   42 },
+    {  1115,  110 },
+    {  1116,  230 },
+    {  1117,  211 },
+    {  1118,   49 },
+    {  1119,  142 },
+    {  1120,   70 },
+    {  1121,   27 },
+    {  1122, -129 },
+    {  1123,  198 },
+    {  1124,   29 },
+    {  1125,  -42 },
+    {  1126,   21 },
+    {  1127,  132 },
+    {  1128,  -45 },
+    {  1129, -190 },
+    {  1130,   35 },
+    {  1131,    8 },
+    {  1132,  224 },
+    {  1133,   71 },
+    {  1135, -142 },
+    {  1136, -158 },
+    {  1137,  102 },
+    {  1138,  -44 },
+    {  1139,  -47 },
+    {  1140,  138 },
+    {  1141,  -12 },
+    {  1142, -244 },
+    {  1144,  -69 },
+    {  1145,   66 },
+    {  1146, -286 },
+    {  1147,  -11 },
+    {  1148, -278 },
+    {  1149,  -97 },
+    {  1150,  137 },
+    {  1151, -204 },
+    {  1153,   73 },
+    {  1154,  -36 },
+    {  1155, -270 },
+    {  1156,  275 },
+    {  1157, -213 },
+    {  1158, -253 },
+    {  1159,  -50 },
+    {  1160,  300 },
+    {  1162,  119 },
+    {  1163, -190 },
+    {  1164,   74 },
+    {  1165,  -56 },
+    {  1166,   83 },
+    {  1167,  134 },
+    {  1168,  263 },
+    {  1169,  143 },
+    {  1170, -103 },
+    {  1171,  106 },
+    {  1172, -101 },
+    {  1173,  -79 },
+    {  1174,   82 },
+    {  1175, -335 },
+    {  1176,  220 },
+    {  1177,  -26 },
+    {  1178, -182 },
+    {  1179,  119 },
+    {  1180,   55 },
+    {  1181,  156 },
+    {  1182,  -20 },
+    {  1183,  103 },
+    {  1184,   11 },
+    {  1185, -104 },
+    {  1186,  -68 },
+    {  1187,  -96 },
+    {  1189,  -77 },
+    {  1190,  -95 },
+    {  1191,   92 },
+    {  1192,   83 },
+    {  1193,  -14 },
+    {  1194, -243 },
+    {  1195,   92 },
+    {  1196, -192 },
+    {  1197,    5 },
+    {  1198,  124 },
+    {  1199,  118 },
+    {  1200,  225 },
+    {  1201,   77 },
+    {  1202,   26 },
+    {  1203, -304 },
+    {  1204,  117 },
+    {  1205, -159 },
+    {  1207, -130 },
+    {  1208,  -56 },
+    {  1209,  186 },
+    {  1210,  201 },
+    {  1211,  216 },
+    {  1212,   91 },
+    {  1213, -225 },
+    {  1214, -188 },
+    {  1216,  -99 },
+    {  1219,   78 },
+    {  1220,   85 },
+    {  1221, -137 },
+    {  1222,   32 },
+    {  1223,   35 },
+    {  1225, -216 },
+    {  1226,   86 },
+    {  1228,  -43 },
+    {  1229, -271 },
+    {  1230,  309 },
+    {  1231, -251 },
+    {  1232, -207 },
+    {  1234,  -47 },
+    {  1235,   -4 },
+    {  1237,  143 },
+    {  1238, -197 },
+    {  1239, -143 },
+    {  1240,  -71 },
+    {  1241,  156 },
+    {  1243,   70 },
+    {  1245,  -49 },
+    {  1246,    7 },
+    {  1247,  122 },
+    {  1248,  -15 },
+    {  1249,  -82 },
+    {  1250,  109 },
+    {  1252,  264 },
+    {  1253,  -74 },
+    {  1254,  145 },
+    {  1255,  185 },
+    {  1256,  -20 },
+    {  1257,   77 },
+    {  1258,  156 },
+    {  1259,  112 },
+    {  1261,  178 },
+    {  1262,  -76 },
+    {  1263,  187 },
+    {  1264,  191 },
+    {  1265, -149 },
+    {  1266,    6 },
+    {  1267,  -82 },
+    {  1268,   86 },
+    {  1270,  155 },
+    {  1272, -119 },
+    {  1273,  248 },
+    {  1274,  178 },
+    {  1275,  -21 },
+    {  1276,  295 },
+    {  1277, -197 },
+    {  1278,  189 },
+    {  1279,  -16 },
+    {  1280,   70 },
+    {  1281,  279 },
+    {  1282,  -94 },
+    {  1283,  362 },
+    {  1284,  279 },
+    {  1285,  -22 },
+    {  1286,  -98 },
+    {  1288,  130 },
+    {  1289,  214 },
+    {  1290,  -47 },
+    {  1291, -148 },
+    {  1292,  219 },
+    {  1293, -163 },
+    {  1294, -175 },
+    {  1295,  -28 },
+    {  1297,  244 },
+    {  1300,  224 },
+    {  1301, -159 },
+    {  1302, -189 },
+    {  1303,  -41 },
+    {  1304, -235 },
+    {  1306,  215 },
+    {  1307,   47 },
+    {  1309,  253 },
+    {  1310,   26 },
+    {  1311, -202 },
+    {  1312, -193 },
+    {  1313,   60 },
+    {  1315,   64 },
+    {  1316, -153 },
+    {  1318,  125 },
+    {  1319,  232 },
+    {  1320, -280 },
+    {  1321,   38 },
+    {  1322,  -55 },
+    {  1324,  198 },
+    {  1326,   68 },
+    {  1327,  -77 },
+    {  1328,   90 },
+    {  1329,   67 },
+    {  1330,  101 },
+    {  1331,  -64 },
+    {  1333,  113 },
+    {  1334,  -52 },
+    {  1335,  339 },
+    {  1336,  106 },
+    {  1337,  283 },
+    {  1338,  159 },
+    {  1339,  -94 },
+    {  1340,  -35 },
+    {  1341,  -27 },
+    {  1342,  179 },
+    {  1343,    1 },
+    {  1344, -118 },
+    {  1345,   81 },
+    {  1346,   82 },
+    {  1347,   50 },
+    {  1348,   99 },
+    {  1349,   75 },
+    {  1351, -214 },
+    {  1353,   90 },
+    {  1354,   30 },
+    {  1355,   77 },
+    {  1356,   13 },
+    {  1357,  111 },
+    {  1358,  -70 },
+    {  1359,  -87 },
+    {  1360,   52 },
+    {  1361,   39 },
+    {  1362,  211 },
+    {  1363,  -10 },
+    {  1364,  134 },
+    {  1366,   62 },
+    {  1367, -205 },
+    {  1369,  -38 },
+    {  1370,  137 },
+    {  1371, -113 },
+    {  1372,  124 },
+    {  1373,   19 },
+    {  1374,   57 },
+    {  1375,  -59 },
+    {  1376, -199 },
+    {  1378, -285 },
+    {  1381,  -15 },
+    {  1382,  -93 },
+    {  1383,  -97 },
+    {  1384,  224 },
+    {  1385,   -5 },
+    {  1387,  -53 },
+    {  1388,  -29 },
+    {  1390,   11 },
+    {  1391, -207 },
+    {  1392, -274 },
+    {  1393,  -84 },
+    {  1394, -335 },
+    {  1396,  158 },
+    {  1397,  -40 },
+    {  1399,    9 },
+    {  1400, -212 },
+    {  1401, -216 },
+    {  1402,   51 },
+    {  1403, -155 },
+    {  1405,  261 },
+    {  1407,  163 },
+    {  1408,  121 },
+    {  1409,  132 },
+    {  1410,  128 },
+    {  1411,  112 },
+    {  1412,   40 },
+    {  1414,   41 },
+    {  1415,  -44 },
+    {  1416,  -60 },
+    {  1417,  116 },
+    {  1418,  198 },
+    {  1419,  221 },
+    {  1420,   56 },
+    {  1421,  -77 },
+    {  1423,   34 },
+    {  1424, -158 },
+    {  1425,  -64 },
+    {  1426,   62 },
+    {  1427, -301 },
+    {  1428,   -7 },
+    {  1429,  -25 },
+    {  1430,  -76 },
+    {  1432,  -46 },
+    {  1434,   72 },
+    {  1435, -103 },
+    {  1436,  290 },
+    {  1437, -116 },
+    {  1438,   86 },
+    {  1439,   73 },
+    {  1440,   39 },
+    {  1441, -111 },
+    {  1442,  228 },
+    {  1443,  176 },
+    {  1444,   34 },
+    {  1445,  179 },
+    {  1446,  -87 },
+    {  1447,  -49 },
+    {  1448, -103 },
+    {  1450, -133 },
+    {  1451, -229 },
+    {  1452,  198 },
+    {  1453,   79 },
+    {  1454,   44 },
+    {  1455, -220 },
+    {  1456,  -46 },
+    {  1457,  -92 },
+    {  2460,  202 },
+    {  2461,  273 },
+    {  2462,  132 },
+    {  2463, -202 },
+    {  2464,  -95 },
+    {  2465, -216 },
+    {  2467,  277 },
+    {  2468,   -6 },
+    {  2470,   71 },
+    {  2471,  -40 },
+    {  2473, -129 },
+    {  2474, -115 },
+    {  2477, -226 },
+    {  2480, -120 },
+    {  2483,   55 },
+    {  2491, -157 },
+    {  2492, -190 },
+    {  2494,  214 },
+    {  2495,  178 },
+    {  2496, -160 },
+    {  2497,   -7 },
+    {  2498,  123 },
+    {  2499,   27 },
+    {  2500, -136 },
+    {  2501,  -86 },
+    {  2503,  -21 },
+    {  2504,  172 },
+    {  2505, -218 },
+    {  2506,  105 },
+    {  2507,   28 },
+    {  2509,  139 },
+    {  2510,  119 },
+    {  2541,   52 },
+    {  2542,  -17 },
+    {  2543,   28 },
+    {  2544,   56 },
+    {  2545,  281 },
+    {  2546,  -74 },
+    {  2548,   95 },
+    {  2549,  105 },
+    {  2551,  -46 },
+    {  2552,   38 },
+    {  2554, -256 },
+    {  2555, -295 },
+    {  2558,  168 },
+    {  2561, -168 },
+    {  2564, -238 },
+    {  2571,  164 },
+    {  2572,   44 },
+    {  2573,  104 },
+    {  2575, -106 },
+    {  2576, -189 },
+    {  2577,  -32 },
+    {  2578,  238 },
+    {  2579,   69 },
+    {  2580,   87 },
+    {  2581, -336 },
+    {  2582, -127 },
+    {  2584,  149 },
+    {  2585,  218 },
+    {  2586,  -63 },
+    {  2587,   80 },
+    {  2588, -192 },
+    {  2589, -357 },
+    {  2590, -211 },
+    {  2591, -261 },
+    {  2623,   45 },
+    {  2624,   24 },
+    {  2626,   57 },
+    {  2627,  181 },
+    {  2629,   25 },
+    {  2630,   43 },
+    {  2632, -130 },
+    {  2633,  -45 },
+    {  2635,   95 },
+    {  2636,  156 },
+    {  2642,   91 },
+    {  2645,  238 },
+    {  2653,   22 },
+    {  2654, -113 },
+    {  2656,  -49 },
+    {  2657, -240 },
+    {  2658, -157 },
+    {  2659,   36 },
+    {  2660,  -79 },
+    {  2662,   92 },
+    {  2663,  -84 },
+    {  2666,   28 },
+    {  2667,   45 },
+    {  2668,  -92 },
+    {  2669,  229 },
+    {  2671,  -42 },
+    {  2672, -201 },
+    {  2731, -135 },
+    {  2737,   30 },
+    {  2738,  -41 },
+    {  2740,   12 },
+    {  2741,   16 },
+    {  2743, -225 },
+    {  2744, -280 },
+    {  2747,   91 },
+    {  2750, -106 },
+    {  2753,  -49 },
+    {  2811,  -30 },
+    {  2812,  289 },
+    {  2813,  161 },
+    {  2818,   65 },
+    {  2819,  127 },
+    {  2821,   88 },
+    {  2822,  303 },
+    {  2824,  -72 },
+    {  2825,  151 },
+    {  2828, -165 },
+    {  2831,  -37 },
+    {  2834,  -76 },
+    {  2899,   11 },
+    {  2900,   58 },
+    {  2902,  187 },
+    {  2903,    8 },
+    {  2905,  -94 },
+    {  2906, -211 },
+    {  2909,  -61 },
+    {  2912, -166 },
+    {  2915, -189 },
+    {  3169, -172 },
+    {  3170,  -12 },
+    {  3172,  118 },
+    {  3173,   87 },
+    {  3175, -265 },
+    {  3176,  -23 },
+    {  3178, -214 },
+    {  3179, -188 },
+    {  3181, -199 },
+    {  3182,  122 },
+    {  3184, -126 },
+    {  3185,  247 },
+    {  3198,  160 },
+    {  3199,   70 },
+    {  3200,  270 },
+    {  3201,  211 },
+    {  3202,  -15 },
+    {  3203,  -12 },
+    {  3205,  265 },
+    {  3206,  185 },
+    {  3207,   38 },
+    {  3208,  197 },
+    {  3209,  139 },
+    {  3210,  209 },
+    {  3211,  204 },
+    {  3212,  161 },
+    {  3228,  136 },
+    {  3229,  -20 },
+    {  3230,  236 },
+    {  3232,  126 },
+    {  3233, -196 },
+    {  3234, -103 },
+    {  3235,  152 },
+    {  3236,  -28 },
+    {  3238, -113 },
+    {  3239,  106 },
+    {  3250,  339 },
+    {  3251,   58 },
+    {  3253,   59 },
+    {  3254,  -24 },
+    {  3256,   58 },
+    {  3257, -249 },
+    {  3259,  120 },
+    {  3260,  -76 },
+    {  3262,  334 },
+    {  3263,  242 },
+    {  3265, -250 },
+    {  3266, -159 },
+    {  3279,  263 },
+    {  3280,  160 },
+    {  3281,  -59 },
+    {  3282,  144 },
+    {  3283,  -72 },
+    {  3284, -153 },
+    {  3286,  121 },
+    {  3287,  121 },
+    {  3288,  180 },
+    {  3289,   43 },
+    {  3290,   58 },
+    {  3291,  -27 },
+    {  3292,  -71 },
+    {  3293, -136 },
+    {  3309,   19 },
+    {  3310, -144 },
+    {  3311, -185 },
+    {  3313,  -21 },
+    {  3314,  -64 },
+    {  3315, -194 },
+    {  3316,  -72 },
+    {  3317, -113 },
+    {  3318,  -74 },
+    {  3319,  -48 },
+    {  3320, -281 },
+    {  3331,  172 },
+    {  3332,  109 },
+    {  3334,  -12 },
+    {  3335,  108 },
+    {  3337,  -53 },
+    {  3338,  -65 },
+    {  3340,  -81 },
+    {  3341, -226 },
+    {  3343, -113 },
+    {  3344,  146 },
+    {  3346,  -32 },
+    {  3347,   23 },
+    {  3360,  -90 },
+    {  3361,  116 },
+    {  3362,  180 },
+    {  3363,  181 },
+    {  3364,  312 },
+    {  3365, -127 },
+    {  3367,  107 },
+    {  3368,   53 },
+    {  3369,  111 },
+    {  3370,  -22 },
+    {  3371,  234 },
+    {  3372,  -90 },
+    {  3373,   51 },
+    {  3374,  155 },
+    {  3390,  131 },
+    {  3391,  304 },
+    {  3392,    4 },
+    {  3394, -143 },
+    {  3395,   43 },
+    {  3396,  152 },
+    {  3397,  168 },
+    {  3398,   -2 },
+    {  3400,  116 },
+    {  3401, -187 },
+    {  3412,  -52 },
+    {  3413,   32 },
+    {  3415, -203 },
+    {  3416,  124 },
+    {  3418,   34 },
+    {  3419,  243 },
+    {  3421,  217 },
+    {  3424,  -94 },
+    {  3425,   10 },
+    {  3427, -155 },
+    {  3428, -170 },
+    {  3439,  158 },
+    {  3440,   93 },
+    {  3442,  138 },
+    {  3443,  -10 },
+    {  3444,  233 },
+    {  3445,    3 },
+    {  3446,   -6 },
+    {  3451,  217 },
+    {  3452, -147 },
+    {  3454,  -17 },
+    {  3466,   45 },
+    {  3467,  -60 },
+    {  3468, -227 },
+    {  3469,  178 },
+    {  3470, -127 },
+    {  3471,    8 },
+    {  3472,   62 },
+    {  3473,   45 },
+    {  3478,  128 },
+    {  3493, -152 },
+    {  3494,   14 },
+    {  3496,  132 },
+    {  3497,  102 },
+    {  3499,   35 },
+    {  3500,   96 },
+    {  3502,  126 },
+    {  3503,  -98 },
+    {  3505,  202 },
+    {  3506,   -6 },
+    {  3508,  190 },
+    {  3509,   89 },
+    {  3520, -216 },
+    {  3521,   41 },
+    {  3523,  264 },
+    {  3524,  196 },
+    {  3525,  379 },
+    {  3526,  309 },
+    {  3527,   74 },
+    {  3529,  -15 },
+    {  3530,   57 },
+    {  3532,  185 },
+    {  3533,  -18 },
+    {  3534,   62 },
+    {  3535,  168 },
+    {  3536,   17 },
+    {  3547,   94 },
+    {  3548,  216 },
+    {  3549,  232 },
+    {  3550,  -63 },
+    {  3551,  222 },
+    {  3552, -115 },
+    {  3553, -271 },
+    {  3554,   61 },
+    {  3556,   64 },
+    {  3557,  -18 },
+    {  3558,   94 },
+    {  3559,  197 },
+    {  3560,  -56 },
+    {  3562, -222 },
+    {  3563,  -66 },
+    {  3574,   49 },
+    {  3575,   33 },
+    {  3577,  262 },
+    {  3578,  197 },
+    {  3580, -112 },
+    {  3581, -143 },
+    {  3601,    1 },
+    {  3602, -144 },
+    {  3604,   70 },
+    {  3605,  209 },
+    {  3606, -134 },
+    {  3607,  244 },
+    {  3608,   -3 },
+    {  3628,  -70 },
+    {  3629, -143 },
+    {  3630, -106 },
+    {  3631,  156 },
+    {  3632,  -54 },
+    {  3633, -113 },
+    {  3634,   70 },
+    {  3635, -198 },
+    {  3907,  -29 },
+    {  3908,  -57 },
+    {  3910, -187 },
+    {  3911,  101 },
+    {  3913,   79 },
+    {  3914,  -38 },
+    {  3936,  -86 },
+    {  3937,   16 },
+    {  3938,  -23 },
+    {  3940,   90 },
+    {  3941,  -66 },
+    {  3967,   66 },
+    {  3968,  134 },
+    {  3988,   11 },
+    {  3989,  -59 },
+    {  3991, -156 },
+    {  3992,    6 },
+    {  3994,  -57 },
+    {  3995,  260 },
+    {  4017,  -54 },
+    {  4018,  110 },
+    {  4019, -213 },
+    {  4021, -123 },
+    {  4022, -184 },
+    {  4048, -133 },
+    {  4049, -233 },
+    {  4069,  -11 },
+    {  4070,    9 },
+    {  4072,   27 },
+    {  4073,   33 },
+    {  4075,  -88 },
+    {  4076, -133 },
+    {  4099,  -16 },
+    {  4100,   39 },
+    {  4102,  274 },
+    {  4103, -244 },
+    {  4129, -203 },
+    {  4130, -176 },
+    {  4141,  -38 },
+    {  4144,   98 },
+    {  4145,  -33 },
+    {  4147, -101 },
+    {  4148,  -15 },
+    {  4171, -196 },
+    {  4172,   72 },
+    {  4174,   79 },
+    {  4198, -183 },
+    {  4222,  -82 },
+    {  4223,   30 },
+    {  4225,  195 },
+    {  4226,  103 },
+    {  4228,  -62 },
+    {  4229, -101 },
+    {  4249,   93 },
+    {  4250,  138 },
+    {  4252,  207 },
+    {  4253,  -34 },
+    {  4254,  -15 },
+    {  4255,  120 },
+    {  4256, -272 },
+    {  4276,  144 },
+    {  4277,   12 },
+    {  4279,    3 },
+    {  4280,  -26 },
+    {  4282,  -77 },
+    {  4283,  -46 },
+    {  7300,  110 },
+    {  7301,  -98 },
+    {  7303,  -47 },
+    {  7304,  -77 },
+    {  7306,   39 },
+    {  7307,   82 },
+    {  7313,  186 },
+    {  7316,  274 },
+    {  7330,  208 },
+    {  7331, -268 },
+    {  7333,  151 },
+    {  7334,  129 },
+    {  7336,  246 },
+    {  7337,  -60 },
+    {  7339,  266 },
+    {  7340,   48 },
+    {  7342,    5 },
+    {  7343,  -44 },
+    {  7360,  -30 },
+    {  7361,  188 },
+    {  7363,  -82 },
+    {  7366,   44 },
+    {  7367,   11 },
+    {  7369,   90 },
+    {  7370, -158 },
+    {  7381,  399 },
+    {  7382, -163 },
+    {  7384,   25 },
+    {  7385,  -74 },
+    {  7388,   53 },
+    {  7391,  -82 },
+    {  7394,  -11 },
+    {  7397,  183 },
+    {  7411,  -85 },
+    {  7412,  277 },
+    {  7414, -154 },
+    {  7415, -108 },
+    {  7417, -110 },
+    {  7418,   25 },
+    {  7420,   24 },
+    {  7421,  233 },
+    {  7423,  -45 },
+    {  7424,  213 },
+    {  7441,  -63 },
+    {  7442, -114 },
+    {  7444,   40 },
+    {  7445,  -48 },
+    {  7447, -295 },
+    {  7448,  -56 },
+    {  7450,   77 },
+    {  7451,  281 },
+    {  7462,  126 },
+    {  7463,   65 },
+    {  7465,  -91 },
+    {  7466,    1 },
+    {  7468, -153 },
+    {  7469, -201 },
+    {  7475,  -27 },
+    {  7478,  197 },
+    {  7492, -266 },
+    {  7493,  116 },
+    {  7495,   10 },
+    {  7496, -270 },
+    {  7498, -224 },
+    {  7501,   38 },
+    {  7502,   42 },
+    {  7504,  -10 },
+    {  7505,  244 },
+    {  7522,  -93 },
+    {  7523,   96 },
+    {  7525,  -68 },
+    {  7528,  245 },
+    {  7529, -180 },
+    {  7531,  -48 },
+    {  7532,  -78 },
+    {  7570,   46 },
+    {  7571, -132 },
+    {  7573,  255 },
+    {  7574,  228 },
+    {  7576,   64 },
+    {  7577,  351 },
+    {  7580,  104 },
+    {  7583,  121 },
+    {  7586,  202 },
+    {  7597,  136 },
+    {  7598, -270 },
+    {  7600,  358 },
+    {  7601,  244 },
+    {  7603,  291 },
+    {  7604,  -41 },
+    {  7606,  -30 },
+    {  7609,  -93 },
+    {  7610,  181 },
+    {  7612,   49 },
+    {  7613, -107 },
+    {  7651,  288 },
+    {  7652,  144 },
+    {  7654,  274 },
+    {  7655,  198 },
+    {  7657,  167 },
+    {  7658,  106 },
+    {  7661,   66 },
+    {  7664,  350 },
+    {  7667,  227 },
+    {  7678,   68 },
+    {  7679,   35 },
+    {  7681,  134 },
+    {  7682, -132 },
+    {  7684,  174 },
+    {  7685,  -24 },
+    {  7687,  207 },
+    {  7688,  198 },
+    {  7690,   89 },
+    {  7691,  -35 },
+    {  7693, -238 },
+    {  7694,  -39 },
+    {  7732,  117 },
+    {  7733,  256 },
+    {  7735, -247 },
+    {  7736, -245 },
+    {  7738, -113 },
+    {  7739,  -83 },
+    {  7742,   19 },
+    {  7745,  133 },
+    {  7748,  221 },
+    {  7759, -120 },
+    {  7760, -229 },
+    {  7762,  242 },
+    {  7763, -227 },
+    {  7765, -136 },
+    {  7766,  -86 },
+    {  7768,  -71 },
+    {  7771, -220 },
+    {  7772, -299 },
+    {  7774,  -96 },
+    {  7775,  -77 },
+    {  7841,  -16 },
+    {  7843,  140 },
+    {  7844,  -24 },
+    {  7846,  106 },
+    {  7847, -172 },
+    {  7853,  175 },
+    {  7856,  -68 },
+    {  7921,   19 },
+    {  7922, -125 },
+    {  7924, -104 },
+    {  7925,  127 },
+    {  7927,   40 },
+    {  7928,  229 },
+    {  7934, -150 },
+    {  7937,  206 },
+    {  8002,  -20 },
+    {  8003,  -88 },
+    {  8005,  280 },
+    {  8006,  340 },
+    {  8008,  111 },
+    {  8009,  168 },
+    {  8015,   39 },
+    {  8018,  138 },
+    {  8041, -108 },
+    {  8068,  285 },
+    {  8069,   38 },
+    {  8071,  187 },
+    {  8072,   -5 },
+    {  8098,  108 },
+    {  8099,  165 },
+    {  8119, -130 },
+    {  8122,  183 },
+    {  8125,  -53 },
+    {  8149,  112 },
+    {  8150, -114 },
+    {  8152,  231 },
+    {  8153,   98 },
+    {  8179,  -34 },
+    {  8180,  144 },
+    {  8230,  221 },
+    {  8231,   72 },
+    {  8233,  -61 },
+    {  8234, -199 },
+    {  8260, -112 },
+    {  8261,  -13 },
+    {  8300,   54 },
+    {  8302,  106 },
+    {  8303,  260 },
+    {  8305,   24 },
+    {  8306, -109 },
+    {  8308,  158 },
+    {  8311,   21 },
+    {  8312,  206 },
+    {  8314,  317 },
+    {  8315,   86 },
+    {  8329,  255 },
+    {  8330,  141 },
+    {  8332,   -5 },
+    {  8338,   74 },
+    {  8381, -132 },
+    {  8383,  -27 },
+    {  8384, -101 },
+    {  8386,  153 },
+    {  8387,  -95 },
+    {  8389,  363 },
+    {  8392,  126 },
+    {  8393,  250 },
+    {  8395,  133 },
+    {  8396, -100 },
+    {  8408,   62 },
+    {  8410,  -95 },
+    {  8411,  -15 },
+    {  8413, -100 },
+    {  8414,   26 },
+    {  8416,  155 },
+    {  8419,  -86 },
+    {  8420,  -87 },
+    {  8422, -215 },
+    {  8423, -153 },
+    {  8462,  -42 },
+    {  8464,   57 },
+    {  8465,   33 },
+    {  8467,  -71 },
+    {  8468,  -58 },
+    {  8470,  -92 },
+    {  8473, -162 },
+    {  8474, -118 },
+    {  8476, -135 },
+    {  8477,    3 },
+    {  8545,  165 },
+    {  8546,  321 },
+    {  8548,  241 },
+    {  8554,  -64 },
+    {  8624,   19 },
+    {  8626, -293 },
+    {  8627,  179 },
+    {  8629,   28 },
+    {  8630, -119 },
+    {  8635,  -73 },
+    {  8636, -125 },
+    {  8638, -170 },
+    {  8639, -305 },
+    {  9760,  196 },
+    {  9761,  134 },
+    {  9763,  152 },
+    {  9764,  -24 },
+    {  9770, -147 },
+    {  9773,  177 },
+    {  9790,   14 },
+    {  9791, -338 },
+    {  9796,  -68 },
+    {  9797, -207 },
+    {  9799,    7 },
+    {  9841,   33 },
+    {  9842,   52 },
+    {  9844,  123 },
+    {  9845,  119 },
+    {  9851,  138 },
+    {  9854,  137 },
+    {  9871,  326 },
+    {  9872,  176 },
+    {  9877,   99 },
+    {  9878,   74 },
+    {  9880,   96 },
+    {  9881,  162 },
+    {  9922,  221 },
+    {  9923,  -59 },
+    {  9925,   12 },
+    {  9926, -122 },
+    {  9932,  -27 },
+    {  9935,  -72 },
+    {  9952,   63 },
+    {  9953, -118 },
+    {  9958,  -40 },
+    {  9959, -279 },
+    {  9961,  -85 },
+    { 10030,  -92 },
+    { 10031,  -91 },
+    { 10033,   86 },
+    { 10034,   95 },
+    { 10040,  230 },
+    { 10111, -222 },
+    { 10112,  100 },
+    { 10114, -152 },
+    { 10115,  303 },
+    { 10121,   62 },
+    { 10192,  -90 },
+    { 10193, -120 },
+    { 10195,  -33 },
+    { 10196,  -38 },
+    { 10202, -215 },
+    { 10498,   88 },
+    { 10499,  -45 },
+    { 10501,  174 },
+    { 10528,  193 },
+    { 10579,  102 },
+    { 10580,  218 },
+    { 10582,   91 },
+    { 10609,  -25 },
+    { 10660, -149 },
+    { 10661,  -42 },
+    { 10663, -205 },
+    { 10690, -197 },
+    { 10733, -126 },
+    { 10735, -111 },
+    { 10742,  -10 },
+    { 10814,  289 },
+    { 10816,  359 },
+    { 10817,   -6 },
+    { 10823,  207 },
+    { 10843,  149 },
+    { 10849,  170 },
+    { 10895,  154 },
+    { 10897,  211 },
+    { 12301, -241 },
+    { 12382,  -47 },
+    { 0, 0 }
+};
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""Self-play with real clocks, for checking time management.
+
+Plays an engine against itself from a few fixed openings, both colors,
+with each side's clock charged the wall time its moves take. Reports the
+time forfeits and the time left on the clocks when the games end.
+
+Usage: python3 tools/selfplay.py <engine> <games> <base seconds> <increment seconds>
+  e.g. python3 tools/selfplay.py src/weixx 8 3 0.03
+"""
+
+import subprocess
+import sys
+import time
+
+OPENINGS = [
+    "x5o/7/7/7/7/7/o5x x 0 1",
+    "x5o/7/2o4/7/4x2/7/o5x x 0 1",
+    "x5o/7/3o3/2x1x2/3o3/7/o5x x 0 1",
+    "x2o2o/7/7/7/7/7/o2x2x x 0 1",
+]
+FILES = "abcdefg"
+
+
+def parse_fen(fen):
+    rows, stm = fen.split()[0].split("/"), fen.split()[1]
+    board = {}
+    for r, row in enumerate(rows):
+        f = 0
+        for c in row:
+            if c.isdigit():
+                f += int(c)
+            else:
+                if c in "xo":
+                    board[FILES[f] + str(7 - r)] = c
+                f += 1
+    return board, stm
+
+
+def make_move(board, stm, move):
+    if move == "0000":
+        return
+    if len(move) == 4:
+        del board[move[:2]]
+    to = move[-2:]
+    board[to] = stm
+    f, r = FILES.index(to[0]), int(to[1]) - 1
+    for df in (-1, 0, 1):
+        for dr in (-1, 0, 1):
+            if 0 <= f + df < 7 and 0 <= r + dr < 7:
+                sq = FILES[f + df] + str(r + dr + 1)
+                if board.get(sq) not in (None, stm, "-"):
+                    board[sq] = stm
+
+
+def game_over(board, halfmoves):
+    x = sum(1 for v in board.values() if v == "x")
+    o = sum(1 for v in board.values() if v == "o")
+    return not x or not o or x + o == 49 or halfmoves >= 100
+
+
+class Engine:
+    def __init__(self, path):
+        self.proc = subprocess.Popen([path], stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+                                     text=True, bufsize=1)
+        self.send("uai")
+        self.send("isready")
+        self.wait("readyok")
+
+    def send(self, line):
+        self.proc.stdin.write(line + "\n")
+        self.proc.stdin.flush()
+
+    def wait(self, prefix):
+        while True:
+            line = self.proc.stdout.readline()
+            if line.startswith(prefix):
+                return line
+
+
+def main():
+    if len(sys.argv) != 5:
+        sys.exit(__doc__)
+
+    path, games = sys.argv[1], int(sys.argv[2])
+    base, inc = float(sys.argv[3]), float(sys.argv[4])
+
+    forfeits, left, plies = 0, [], 0
+
+    for g in range(games):
+        fen = OPENINGS[(g // 2) % len(OPENINGS)]
+        board, stm = parse_fen(fen)
+        engines = [Engine(path), Engine(path)]
+        first = stm if g % 2 == 0 else ("o" if stm == "x" else "x")
+        clock = {"x": base, "o": base}
+        moves, halfmoves = [], 0
+
+        while not game_over(board, halfmoves):
+            engine = engines[0] if stm == first else engines[1]
+            engine.send(f"position fen {fen}" + (" moves " + " ".join(moves) if moves else ""))
+
+            start = time.perf_counter()
+            engine.send(f"go wtime {int(clock['o'] * 1000)} btime {int(clock['x'] * 1000)}"
+                        f" winc {int(inc * 1000)} binc {int(inc * 1000)}")
+            move = engine.wait("bestmove").split()[1]
+            clock[stm] -= time.perf_counter() - start
+
+            if clock[stm] < 0:
+                forfeits += 1
+                break
+
+            clock[stm] += inc
+            halfmoves = 0 if len(move) == 2 else halfmoves + 1
+            make_move(board, stm, move)
+            moves.append(move)
+            plies += 1
+            stm = "o" if stm == "x" else "x"
+
+        left += [clock["x"], clock["o"]]
+        for engine in engines:
+            engine.send("quit")
+
+    print(f"games {games} tc {base}+{inc}: forfeits {forfeits}  plies {plies}  "
+          f"avg time left {sum(left) / len(left):.2f}s  min {min(left):.2f}s")
+
+
+if __name__ == "__main__":
+    main()